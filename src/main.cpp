@@ -1,11 +1,29 @@
 #include <iostream>
+#include <memory>
+#include <chrono>
+#include <vector>
 
 #include <ngin/job/ngin.h>
+#include <ngin/job/pipeline.h>
 
 #include <ngin/debug/manager.h>
 #include <ngin/asset/manager.h>
 #include <ngin/render/manager.h>
 #include <ngin/scene/object/manager.h>
+#include <ngin/atlas/atlas.h>
+#include <ngin/util/file.h>
+
+/**
+ * @brief Everything one frame's simulation produces and its presentation consumes.
+ * The frame pipeline keeps one per frame in flight, so frame N+1 is simulated from frame N's
+ * copy while frame N is being presented.
+ */
+struct FrameState {
+    uint64_t frame = 0;      ///< @brief The frame this state was simulated for.
+    float time_delta = 0.0f; ///< @brief Seconds since the previous frame, staged from the window clock.
+    float time = 0.0f;       ///< @brief Simulated seconds up to and including this frame.
+    std::vector<ngin::scene::ObjectSnapshot> objects; ///< @brief The scene as this frame left it, parents first.
+};
 
 /**
  * @brief The main application class for the Ngin engine.
@@ -44,22 +62,25 @@ private:
     // temp
     ngin::scene::ObjectManager object_mgr_; ///< @brief Manages scene objects (temporary).
 
+    std::unique_ptr<ngin::jobs::FramePipeline<FrameState>> frame_pipeline_; ///< @brief Overlaps simulating frame N+1 with presenting frame N.
+    std::chrono::microseconds main_thread_budget_{2000}; ///< @brief Time per frame spent on jobs queued for the main thread.
+
     /**
      * @brief Initializes all core Ngin engine components.
      *
-     * This includes setting up asset management, processing initial asset jobs,
-     * initializing the render manager, and building initial scene objects.
+     * This includes initializing the render manager, setting up asset management,
+     * processing initial asset jobs, and building initial scene objects.
      */
     void init_() {
 
-        // Asset setup
+        // Render setup, first so the GL context exists for the asset uploads
+            render_mgr_.setup();
+
+        // Asset setup. Waiting here also runs the uploads workers hand to the main thread.
             JobHandle asset_setup_handle = asset_mgr_.process_setup_jobs(job_ngin_);
             job_ngin_.wait_for(asset_setup_handle);
             asset_mgr_.debug_show();
             asset_mgr_.log_snapshot();
-        
-        // Render setup
-            render_mgr_.setup();
 
         // Scene setup
             std::string object_origin = "sphere";
@@ -71,24 +92,72 @@ private:
                 // @warning Log an error if the object asset isn't found.
                 std::cerr << "Warning: Object asset '" << object_origin << "' not found." << std::endl;
             }
+
+        // Frame pipeline setup
+            setup_frame_pipeline_();
+    }
+
+    /**
+     * @brief Creates the frame pipeline, configured by `frame.depth`, `frame.sync_interval` and
+     * `frame.main_thread_budget_us` in data/game.atl.
+     *
+     * Each frame polls input on the main thread, then a worker applies pending hierarchy edits
+     * and snapshots the scene into the frame's state, while the main thread draws and swaps the
+     * frame before it. A depth of 1 runs these back to back; 2 or more lets the workers simulate
+     * that many frames ahead. Every `sync_interval` frames the pipeline drains and module edits,
+     * which may touch GPU resources, are applied on the main thread.
+     */
+    void setup_frame_pipeline_() {
+        ngin::jobs::FramePipelineOptions options;
+        options.sync_interval = 16;
+        int depth = static_cast<int>(options.depth);
+        int sync_interval = static_cast<int>(options.sync_interval);
+        int main_thread_budget = static_cast<int>(main_thread_budget_.count());
+
+        std::tuple<std::string, bool> resource_path = FileUtil::get_resource_path("data/game.atl");
+        Atlas data;
+        data.read(std::get<0>(resource_path));
+        options.depth = static_cast<size_t>(std::max(1, *data.get<int>("frame.depth", &depth)));
+        options.sync_interval = static_cast<size_t>(std::max(1, *data.get<int>("frame.sync_interval", &sync_interval)));
+        main_thread_budget_ = std::chrono::microseconds(std::max(0, *data.get<int>("frame.main_thread_budget_us", &main_thread_budget)));
+
+        ngin::jobs::FrameStages<FrameState> stages;
+        stages.stage = [this](FrameState& next, uint64_t) {
+            render_mgr_.update_early();
+            next.time_delta = render_mgr_.get_render_data().time_delta;
+        };
+        stages.simulate = [this](const FrameState& previous, FrameState& next, uint64_t frame) {
+            next.frame = frame;
+            next.time = previous.time + next.time_delta;
+            object_mgr_.apply_hierarchy_edits();
+            next.objects = object_mgr_.snapshot();
+        };
+        stages.present = [this](const FrameState&, uint64_t) {
+            render_mgr_.render();
+            render_mgr_.update_late();
+        };
+        stages.sync = [this]() {
+            object_mgr_.apply_module_edits();
+        };
+        frame_pipeline_ = std::make_unique<ngin::jobs::FramePipeline<FrameState>>(job_ngin_, std::move(stages), options);
     }
 
     /**
      * @brief The main application update loop.
      *
      * This loop continues as long as the render manager indicates that the
-     * application window should not close. It performs early and late
-     * rendering updates.
+     * application window should not close. Each iteration runs the jobs queued for
+     * the main thread, then advances the frame pipeline: the next frame is staged and
+     * handed to the workers, and the oldest finished frame is presented.
      */
     void update_() {
         while (!render_mgr_.should_close()) {
-            render_mgr_.update_early();
+            job_ngin_.mark_frame(); // Frame boundary for JobNgin::start_trace captures
 
-            // @todo Add game logic, input processing, physics updates here.
-            
+            // GL work handed back by worker jobs, e.g. shader uploads, within this frame's budget
+            job_ngin_.main_thread_queue().run(main_thread_budget_);
 
-
-            render_mgr_.update_late();
+            frame_pipeline_->advance();
         }
     }
 
@@ -99,6 +168,7 @@ private:
      * release resources, primarily by cleaning up the render manager.
      */
     void cleanup_() {
+        frame_pipeline_.reset(); // Waits for frames still simulating
         render_mgr_.cleanup();
     }
 };
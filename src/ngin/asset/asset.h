@@ -9,7 +9,19 @@ public:
     Asset(unsigned int id, std::string name) : id_(id), name_(name) {}
     virtual ~Asset() {}
     virtual void read(const std::string& filepath, ngin::debug::Printer& debug) = 0;
+    // Reads from the file's contents, already loaded (e.g. by FileReader). Types that can parse
+    // from memory override this; the default reads the file again itself.
+    virtual void read_contents(const std::string& filepath, const std::string& contents, ngin::debug::Printer& debug) {
+        read(filepath, debug);
+    }
     virtual void write(const std::string& filepath) const = 0;
+    // True if the asset has GPU resources to create once read; see upload.
+    virtual bool needs_upload() const {
+        return false;
+    }
+    // Creates the asset's GPU resources. Needs the GL context, so it only runs on the main thread,
+    // after read or read_contents.
+    virtual void upload() {}
     std::string& get_name() {
         return name_;
     }
@@ -11,6 +11,7 @@
 
 #include <ngin/job/collections/vector.h>
 #include <ngin/job/collections/map.h>
+#include <ngin/job/io.h>
 
 #include <string>
 #include <unordered_map>
@@ -107,27 +108,60 @@ public:
         delete manifest;
     }
 
-    std::vector<std::function<void()>> generate_preload_jobs(ngin::debug::Printer& debug) {
-        std::vector<std::function<void()>> jobs;
+    /**
+     * @brief Starts reading every preload asset through `reader`, without blocking the caller.
+     * Each asset is parsed by a continuation job once its file has arrived, and its GPU side,
+     * if any, is created by a job on the main thread after that.
+     * @param handle Completes once every preload asset has been parsed and uploaded.
+     */
+    void preload_async(ngin::jobs::FileReader& reader, JobHandle& handle, ngin::debug::Printer& debug) {
         for (const auto& asset : manifest_.data) {
-
             std::optional<AssetData> asset_data = manifest_.get(asset.first);
-            if (!asset_data) {
-                continue;
-            }
-            AssetData* asset_data_val = &asset_data.value();
-
-            if (asset_data_val->preload) {
-                jobs.push_back(generate_asset_load_job(asset.first, debug));
+            if (asset_data && asset_data->preload) {
+                load_async(asset.first, reader, handle, debug);
             }
         }
-        return jobs;
     }
-    std::function<void()> generate_asset_load_job(const std::string& asset_name, ngin::debug::Printer& debug) {
-        return [this, asset_name, &debug]() {
-            load(asset_name, debug);
-        };
+    // Like load, but the file is read by `reader` and parsed in a continuation job counted against `handle`,
+    // as is the upload the continuation hands to the main thread.
+    void load_async(const std::string& asset_name, ngin::jobs::FileReader& reader, JobHandle& handle, ngin::debug::Printer& debug) {
+        std::optional<AssetData> asset_data = manifest_.get(asset_name);
+        if (!asset_data) {
+            return;
+        }
+
+        debug.info("Loading asset: " + asset_name + ", of kind: " + asset_data->kind + ", at location: " + asset_data->location, debug_name_);
+
+        std::optional<AssetBucket::AssetFactory> factory = get_asset_factories().get(asset_data->kind);
+        std::tuple<std::string, bool> asset_path = FileUtil::get_generic_asset_path(asset_data->location);
+        if (!factory || !std::get<1>(asset_path)) {
+            return;
+        }
+        ngin::jobs::MainThreadQueue& main_thread = reader.job_ngin().main_thread_queue();
+        // Keeps `handle` on one counter until the read is queued, so the copy the continuation takes is still live.
+        handle.add_pending(1);
+        reader.read_file(std::get<0>(asset_path), [this, asset_name, factory = *factory, &debug, &main_thread, handle](ngin::jobs::FileReadResult& result) mutable {
+            if (!result.ok()) {
+                logger_->error("Could not read asset '" + asset_name + "' from " + result.path);
+                return;
+            }
+            unsigned int id = IdUtil::get_unique_id();
+            std::shared_ptr<Asset> asset = factory(id, asset_name);
+            asset->read_contents(result.path, result.bytes, debug);
+            if (asset->needs_upload()) {
+                // Counted against `handle` too, so the load only completes once the GPU side exists.
+                main_thread.submit([asset]() {
+                    asset->upload();
+                }, handle);
+            }
+
+            assets_.add(id, asset);
+            name_to_id_mapping_.add(asset_name, id);
+        }, JobType::AssetLoading, handle);
+        handle.complete();
     }
+    // Reads, parses and uploads the asset on the calling thread, which must hold the GL context.
+    // Worker jobs use load_async, which hands the upload to the main thread.
     void load(const std::string& asset_name, ngin::debug::Printer& debug) {
         std::optional<AssetData> asset_data = manifest_.get(asset_name);
         if (!asset_data) {
@@ -200,6 +234,9 @@ private:
             std::tuple<std::string, bool> asset_path = FileUtil::get_generic_asset_path(location);
             if (std::get<1>(asset_path)) {
                 asset->read(std::get<0>(asset_path), debug);
+                if (asset->needs_upload()) {
+                    asset->upload(); // Synchronous loads run on the caller, which must hold the GL context
+                }
 
                 assets_.add(id, asset);
                 name_to_id_mapping_.add(asset_name, id);
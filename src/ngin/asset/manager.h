@@ -4,7 +4,9 @@
 #include <ngin/debug/logger.h>
 #include <ngin/debug/bucket.h>
 
+#include <ngin/job/io.h>
 #include <ngin/job/ngin.h>
+#include <ngin/job/task.h>
 
 #include <ngin/asset/bucket.h>
 
@@ -19,6 +21,12 @@ public:
         setup_buckets_();
     }
     ~AssetManager() {
+        if (file_reader_) {
+            preload_handle_.cancel(); // Preloads still queued are no longer wanted
+            // Parses and uploads already running still write to the buckets; let them finish.
+            file_reader_->job_ngin().wait_for(preload_handle_);
+            file_reader_.reset(); // Lets reads in flight hand off before the buckets go
+        }
         delete logger_;
         for (auto& bucket : buckets_) {
             delete bucket.second;
@@ -33,29 +41,18 @@ public:
         return buckets_[bucket]->get<T>(name);
     }
 
+    /**
+     * @brief Sets up every bucket, then preloads their assets, without blocking the caller.
+     * @return A handle that completes once all preload jobs have finished.
+     */
     JobHandle process_setup_jobs(ngin::jobs::JobNgin& job_ngin) {
         logger_->info("Asset processing setup jobs");
-
-        ngin::debug::Printer& printer = debugger_.get_context();
-
-        std::vector<std::function<void()>> bucket_setup_tasks;
-        for (auto& bucket : buckets_) {
-            bucket_setup_tasks.push_back([&, bucket_ptr = bucket.second]() {
-                bucket_ptr->setup(printer);
-            });
+        if (!file_reader_) {
+            file_reader_ = std::make_unique<ngin::jobs::FileReader>(job_ngin);
         }
-        JobHandle buckets_setup_handle = job_ngin.submit_jobs(bucket_setup_tasks, JobType::AssetSetup);
-        job_ngin.wait_for(buckets_setup_handle);
-
-        std::vector<std::function<void()>> preload_tasks;
-        for (auto& bucket : buckets_) {
-            for (auto& job : bucket.second->generate_preload_jobs(printer)) {
-                preload_tasks.push_back(job);
-            }
-        }
-        JobHandle preload_handle = job_ngin.submit_jobs(preload_tasks, JobType::AssetLoading);
-
-        return preload_handle;
+        // Armed here, so the setup task only adds to it and cancel_preload never sees it re-pointed.
+        preload_handle_.add_pending(1);
+        return ngin::jobs::spawn(job_ngin, setup_task_(job_ngin), JobType::AssetSetup);
     }
     void debug_show() {
         debugger_.show();
@@ -67,6 +64,11 @@ public:
 
     }
 
+    // Drops preload reads and parses that have not started yet; the setup handle still completes.
+    void cancel_preload() {
+        preload_handle_.cancel();
+    }
+
     void log_snapshot() {
         logger_->info("Asset Snapshot:");
         for (auto& bucket : buckets_) {
@@ -81,6 +83,30 @@ private:
     ngin::debug::Logger* logger_;
     ngin::debug::DebugBucket debugger_;
     std::unordered_map<std::string, AssetBucket*> buckets_;
+    std::unique_ptr<ngin::jobs::FileReader> file_reader_; // Preload reads; created with the first setup
+    JobHandle preload_handle_; // Every preload read and parse, for cancel_preload
+
+    // The setup pipeline. Each stage resumes on the worker that finishes the previous one.
+    ngin::jobs::Task<> setup_task_(ngin::jobs::JobNgin& job_ngin) {
+        ngin::debug::Printer& printer = debugger_.get_context();
+
+        std::vector<std::function<void()>> bucket_setup_tasks;
+        for (auto& bucket : buckets_) {
+            bucket_setup_tasks.push_back([&, bucket_ptr = bucket.second]() {
+                bucket_ptr->setup(printer);
+            });
+        }
+        JobHandle buckets_setup_handle = job_ngin.submit_jobs(std::move(bucket_setup_tasks), JobType::AssetSetup);
+        co_await buckets_setup_handle;
+
+        // Preload files are read asynchronously; each asset is parsed by a job once its bytes arrive.
+        JobHandle preload_handle = preload_handle_;
+        for (auto& bucket : buckets_) {
+            bucket.second->preload_async(*file_reader_, preload_handle, printer);
+        }
+        preload_handle.complete(); // The count process_setup_jobs armed it with
+        co_await preload_handle;
+    }
 
     void setup_buckets_() {
         // Create the mesh bucket
@@ -26,6 +26,11 @@ public:
         data->read(filepath);
         data_.from_data(*data);
     }
+    void read_contents(const std::string& filepath, const std::string& contents, ngin::debug::Printer& debug) override {
+        Atlas data;
+        data.parse(contents);
+        data_.from_data(data);
+    }
     void write(const std::string& filepath) const override {
     }
     
@@ -4,6 +4,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
 
 #include <ngin/atlas/atlas.h>
 #include <ngin/debug/logger.h>
@@ -27,9 +28,27 @@ public:
     }
 
     void read(const std::string& filepath, ngin::debug::Printer& debug) override {
-        Atlas* data = new Atlas();
-        data->read(filepath);        
+        atlas_ = std::make_unique<Atlas>();
+        atlas_->read(filepath);
+        read_atlas_(atlas_.get(), filepath, debug);
+    }
+    void read_contents(const std::string& filepath, const std::string& contents, ngin::debug::Printer& debug) override {
+        atlas_ = std::make_unique<Atlas>();
+        atlas_->parse(contents);
+        read_atlas_(atlas_.get(), filepath, debug);
+    }
+    void write(const std::string& filepath) const override {
+
+    }
+    
+private:
+    ngin::debug::Logger* logger_;
+    std::unique_ptr<Atlas> atlas_; // The parsed file; data_ keeps pointers into it
+    ObjectData* data_ = nullptr;
+
+    std::string debug_name_ = "ObjectAsset::";
 
+    void read_atlas_(Atlas* data, const std::string& filepath, ngin::debug::Printer& debug) {
         Atlas* children = data->get<Atlas>("children");
         data_ = new ObjectData();
         if (children) {
@@ -43,16 +62,6 @@ public:
         }
         debug.info("Loaded object asset: " + filepath + ", size: " + std::to_string(data_->get_deep_memory_usage()) + " bytes", debug_name_);
     }
-    void write(const std::string& filepath) const override {
-
-    }
-    
-private:
-    ngin::debug::Logger* logger_;
-    ObjectData* data_;
-
-    std::string debug_name_ = "ObjectAsset::";
-    
 };
 
 #endif // OBJECT_ASSET_H
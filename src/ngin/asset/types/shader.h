@@ -7,6 +7,7 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 
 #include <ngin/atlas/atlas.h>
 #include <ngin/debug/logger.h>
@@ -26,6 +27,17 @@ public:
         Atlas *data = new Atlas();
         data->read(filepath);
         data_.from_data(*data);
+    }
+    void read_contents(const std::string &filepath, const std::string &contents, ngin::debug::Printer &debug) override {
+        atlas_ = std::make_unique<Atlas>();
+        atlas_->parse(contents);
+        data_.from_data(*atlas_);
+    }
+    bool needs_upload() const override {
+        return true;
+    }
+    // Compiles and links the program; reads run on workers, where no GL context is current.
+    void upload() override {
         gl_data_.load();
     }
     void write(const std::string &filepath) const override
@@ -35,6 +47,7 @@ public:
 private:
     ngin::debug::Logger *logger_;
 
+    std::unique_ptr<Atlas> atlas_; // Parsed by read_contents; ShaderData::attributes points into it
     ShaderData data_;
     GlShaderData gl_data_;
 };
@@ -152,38 +152,12 @@ public:
     }
     void read(const std::string& filename) {
         std::ifstream file(filename);
-        std::string line;
-
-        std::unordered_map<int, Atlas*> dictStack;
-        dictStack[-1] = this;
-
-        std::string collectionName = std::string("");
-
-        for (std::string line; getline(file, line); ) {
-            if (line.empty() || (line[0] == '/' && line[1] == '/')) continue;
-
-            int indent = line.find_first_not_of(' ');
-            indent = indent / 4;
-
-            line = trim_(line);
-            int delimiterPos = line.find(':');
-            if (delimiterPos == (int)std::string::npos) {
-                continue;
-            } else {
-                std::string key = line.substr(0, delimiterPos);
-                std::string value = delimiterPos < (int)line.size() - 1 ? trim_(line.substr(delimiterPos + 1)) : "";
-                if (value == "") {
-                    // could be a list of a dict
-                    dictStack[indent - 1]->set(key, *(new Atlas()));
-                    dictStack[indent] = dictStack[indent - 1]->get<Atlas>(key);
-
-                } else {
-                    parse_atlas_element_(dictStack[indent - 1], key, value);
-                }
-            }
-
-            // currentIndent = indent;
-        }
+        read_stream_(file);
+    }
+    // Same as read, from text already loaded into memory.
+    void parse(const std::string& text) {
+        std::istringstream stream(text);
+        read_stream_(stream);
     }
     void write(const std::string& filepath) const {
         
@@ -304,6 +278,41 @@ private:
     std::unordered_map<std::string, std::any>* data_;
     std::vector<std::string>* keyOrder_; // Stores keys in insertion order
 
+    void read_stream_(std::istream& file) {
+        std::string line;
+
+        std::unordered_map<int, Atlas*> dictStack;
+        dictStack[-1] = this;
+
+        std::string collectionName = std::string("");
+
+        for (std::string line; getline(file, line); ) {
+            if (line.empty() || (line[0] == '/' && line[1] == '/')) continue;
+
+            int indent = line.find_first_not_of(' ');
+            indent = indent / 4;
+
+            line = trim_(line);
+            int delimiterPos = line.find(':');
+            if (delimiterPos == (int)std::string::npos) {
+                continue;
+            } else {
+                std::string key = line.substr(0, delimiterPos);
+                std::string value = delimiterPos < (int)line.size() - 1 ? trim_(line.substr(delimiterPos + 1)) : "";
+                if (value == "") {
+                    // could be a list of a dict
+                    dictStack[indent - 1]->set(key, *(new Atlas()));
+                    dictStack[indent] = dictStack[indent - 1]->get<Atlas>(key);
+
+                } else {
+                    parse_atlas_element_(dictStack[indent - 1], key, value);
+                }
+            }
+
+            // currentIndent = indent;
+        }
+    }
+
     std::string trim_(const std::string& str) {
         size_t first = str.find_first_not_of(' ');
         if (std::string::npos == first) {
@@ -14,9 +14,6 @@ class ModuleData {
 
 public:
     ModuleData(std::string name) : name_(name) {}
-    ~ModuleData() {
-        delete args_;
-    }
 
     void from_atlas(Atlas* data) {
         std::string* kind_ptr = nullptr;
@@ -49,7 +46,7 @@ public:
         total_memory += kind_.capacity();
 
         // Add memory for the Atlas pointed to by args_
-        // This is crucial because ModuleData owns and deletes args_.
+        // args_ points into the atlas the module was read from, which its owner frees.
         // Assuming Atlas has a get_deep_memory_usage() or a way to determine its size.
         // For simplicity, let's estimate Atlas size. A real Atlas would likely
         // be complex and need its own deep memory calculation.
@@ -77,7 +74,7 @@ private:
     std::string name_;
     std::string kind_;
 
-    Atlas* args_;
+    Atlas* args_ = nullptr; // Not owned: part of the atlas the module was read from
 };
 
 #endif // MODULE_DATA_H
\ No newline at end of file
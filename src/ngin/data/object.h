@@ -24,9 +24,6 @@ public:
         for (auto& module : modules_) {
             delete module;
         }
-        if (transform_atlas_) {
-            delete transform_atlas_;
-        }
     }
 
     std::string& get_name() {
@@ -123,7 +120,7 @@ private:
     std::vector<ObjectData*> children_;
     std::vector<ModuleData*> modules_;
     TransformData transform_;
-    Atlas* transform_atlas_;
+    Atlas* transform_atlas_ = nullptr; // Not owned: part of the atlas the object was read from
 };
 
 #endif // OBJECT_DATA_H
\ No newline at end of file
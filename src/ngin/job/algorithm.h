@@ -0,0 +1,370 @@
+#ifndef JOB_ALGORITHM_H
+#define JOB_ALGORITHM_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <ngin/job/ngin.h>
+
+/**
+ * @file algorithm.h
+ * @brief Data-parallel reduce, inclusive scan, sort and radix sort on JobNgin.
+ *
+ * Each algorithm cuts its input into contiguous blocks and runs them through
+ * JobNgin::parallel_for, so idle workers steal ranges of blocks from busy ones. The caller
+ * blocks in wait_for, which means it helps run the blocks (or, on a fiber, parks). Partial
+ * results are always combined in block order, so a result never depends on which worker
+ * ran which block.
+ */
+
+namespace ngin {
+namespace jobs {
+
+namespace detail {
+
+// Fewest elements worth a block of their own when the caller passes no grain.
+static constexpr size_t DEFAULT_ALGORITHM_GRAIN = 4096;
+
+// Splits `count` elements into blocks of at least `grain`, at most eight per worker.
+inline size_t algorithm_block_count(const JobNgin& job_ngin, size_t count, size_t grain) {
+    grain = grain == 0 ? DEFAULT_ALGORITHM_GRAIN : grain;
+    size_t most = static_cast<size_t>(job_ngin.num_threads()) * 8;
+    return std::max<size_t>(1, std::min(count / grain, most));
+}
+
+// First element of block `block` of `blocks` over `count` elements.
+inline size_t algorithm_block_begin(size_t count, size_t blocks, size_t block) {
+    return count / blocks * block + std::min(block, count % blocks);
+}
+
+// Runs `fn(block)` for every block and waits for all of them.
+template<typename Fn>
+void for_each_block(JobNgin& job_ngin, size_t blocks, JobType type, Fn&& fn) {
+    if (blocks == 1) {
+        fn(size_t{0});
+        return;
+    }
+    JobHandle handle = job_ngin.parallel_for(0, blocks, 1, [&fn](size_t block) {
+        fn(block);
+    }, type);
+    job_ngin.wait_for(handle);
+}
+
+/**
+ * @brief Where the first `diagonal` elements of merging a and b end in a, with ties taken from a.
+ * The rest of those elements are the first `diagonal - result` of b.
+ */
+template<typename It, typename Compare>
+size_t merge_path_split(It a, size_t a_size, It b, size_t b_size, size_t diagonal, Compare& comp) {
+    size_t low = diagonal > b_size ? diagonal - b_size : 0;
+    size_t high = std::min(diagonal, a_size);
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (comp(b[diagonal - mid - 1], a[mid])) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return low;
+}
+
+}
+
+/**
+ * @brief Combines `map(i)` for every i in [begin, end) with `combine`, starting from `identity`.
+ * `combine` must be associative and `identity` neutral for it; it need not be commutative.
+ * @param grain Fewest indices per block. Pass 0 for a default suited to cheap `map`s.
+ * @return identity when the range is empty.
+ */
+template<typename T, typename Map, typename Combine>
+T parallel_reduce(JobNgin& job_ngin, size_t begin, size_t end, T identity, Map map, Combine combine,
+                  size_t grain = 0, JobType type = JobType::Other) {
+    if (begin >= end) {
+        return identity;
+    }
+    size_t count = end - begin;
+    size_t blocks = detail::algorithm_block_count(job_ngin, count, grain);
+    std::vector<T> partials(blocks, identity);
+    detail::for_each_block(job_ngin, blocks, type, [&](size_t block) {
+        size_t block_end = begin + detail::algorithm_block_begin(count, blocks, block + 1);
+        T value = identity;
+        for (size_t i = begin + detail::algorithm_block_begin(count, blocks, block); i < block_end; ++i) {
+            value = combine(std::move(value), map(i));
+        }
+        partials[block] = std::move(value);
+    });
+
+    T result = std::move(identity);
+    for (T& partial : partials) {
+        result = combine(std::move(result), std::move(partial));
+    }
+    return result;
+}
+
+/**
+ * @brief Writes the running `op`-combination of [first, last) to the range starting at `out`,
+ * like std::inclusive_scan. `op` must be associative. `out` may equal `first`.
+ *
+ * Three passes: every block reduces its elements, the block totals are scanned serially,
+ * then every block scans its elements again starting from the total of the blocks before it.
+ */
+template<typename InIt, typename OutIt, typename Op>
+void parallel_inclusive_scan(JobNgin& job_ngin, InIt first, InIt last, OutIt out, Op op,
+                             size_t grain = 0, JobType type = JobType::Other) {
+    using T = typename std::iterator_traits<InIt>::value_type;
+    size_t count = static_cast<size_t>(std::distance(first, last));
+    if (count == 0) {
+        return;
+    }
+    size_t blocks = detail::algorithm_block_count(job_ngin, count, grain);
+    auto block_range = [&](size_t block) {
+        return std::make_pair(detail::algorithm_block_begin(count, blocks, block), detail::algorithm_block_begin(count, blocks, block + 1));
+    };
+
+    // Total of every block but the last, whose total no later block needs.
+    std::vector<T> totals;
+    totals.reserve(blocks);
+    for (size_t block = 0; block < blocks; ++block) {
+        totals.push_back(first[block_range(block).first]);
+    }
+    if (blocks > 1) {
+        detail::for_each_block(job_ngin, blocks - 1, type, [&](size_t block) {
+            auto [block_begin, block_end] = block_range(block);
+            T total = first[block_begin];
+            for (size_t i = block_begin + 1; i < block_end; ++i) {
+                total = op(std::move(total), first[i]);
+            }
+            totals[block] = std::move(total);
+        });
+        // totals[b] becomes the combination of every element before block b + 1.
+        for (size_t block = 1; block < blocks - 1; ++block) {
+            totals[block] = op(totals[block - 1], totals[block]);
+        }
+    }
+
+    detail::for_each_block(job_ngin, blocks, type, [&](size_t block) {
+        auto [block_begin, block_end] = block_range(block);
+        T running = block == 0 ? T(first[block_begin]) : op(totals[block - 1], first[block_begin]);
+        out[block_begin] = running;
+        for (size_t i = block_begin + 1; i < block_end; ++i) {
+            running = op(std::move(running), first[i]);
+            out[i] = running;
+        }
+    });
+}
+
+/**
+ * @brief Sorts [first, last) by `comp`, like std::sort: a parallel merge sort.
+ * Blocks are sorted with std::sort, then merged pairwise in rounds through a scratch buffer.
+ * Every merge of a round is cut at merge-path splits into pieces run as separate blocks, so
+ * the last rounds, with only one or two merges left, still use every worker. Not stable.
+ */
+template<typename It, typename Compare = std::less<>>
+void parallel_sort(JobNgin& job_ngin, It first, It last, Compare comp = Compare(), JobType type = JobType::Other) {
+    using T = typename std::iterator_traits<It>::value_type;
+    size_t count = static_cast<size_t>(std::distance(first, last));
+    size_t blocks = detail::algorithm_block_count(job_ngin, count, 0);
+    if (blocks == 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    // Run r spans [runs[r], runs[r + 1]).
+    std::vector<size_t> runs(blocks + 1);
+    for (size_t block = 0; block <= blocks; ++block) {
+        runs[block] = detail::algorithm_block_begin(count, blocks, block);
+    }
+    detail::for_each_block(job_ngin, blocks, type, [&](size_t block) {
+        std::sort(first + runs[block], first + runs[block + 1], comp);
+    });
+
+    std::vector<T> buffer(count);
+    T* scratch = buffer.data();
+    bool in_scratch = false; // Whether the sorted runs currently live in `buffer`
+    while (runs.size() > 2) {
+        size_t run_count = runs.size() - 1;
+        size_t merges = run_count / 2;
+        size_t pieces = std::max<size_t>(1, blocks / merges); // Per merge
+
+        // Where each piece of each merge starts in its first run. Found before any piece moves
+        // elements out of the source, since a search reaches past its own piece.
+        auto merge_bounds = [&](size_t merge, size_t piece) {
+            size_t total = runs[2 * merge + 2] - runs[2 * merge];
+            return total / pieces * piece + std::min(piece, total % pieces);
+        };
+        std::vector<size_t> splits(merges * (pieces + 1));
+        auto find_splits = [&](auto source) {
+            for (size_t merge = 0; merge < merges; ++merge) {
+                size_t a_begin = runs[2 * merge];
+                size_t b_begin = runs[2 * merge + 1];
+                size_t b_end = runs[2 * merge + 2];
+                for (size_t piece = 0; piece <= pieces; ++piece) {
+                    splits[merge * (pieces + 1) + piece] = detail::merge_path_split(
+                        source + a_begin, b_begin - a_begin, source + b_begin, b_end - b_begin, merge_bounds(merge, piece), comp);
+                }
+            }
+        };
+        auto merge_piece = [&](auto source, auto target, size_t task) {
+            size_t merge = task / pieces;
+            size_t piece = task % pieces;
+            if (merge == merges) {
+                // An odd run out moves across unmerged.
+                std::move(source + runs[run_count - 1], source + runs[run_count], target + runs[run_count - 1]);
+                return;
+            }
+            size_t a_begin = runs[2 * merge];
+            size_t b_begin = runs[2 * merge + 1];
+            size_t from = merge_bounds(merge, piece);
+            size_t to = merge_bounds(merge, piece + 1);
+            size_t a_from = splits[merge * (pieces + 1) + piece];
+            size_t a_to = splits[merge * (pieces + 1) + piece + 1];
+            std::merge(std::make_move_iterator(source + a_begin + a_from), std::make_move_iterator(source + a_begin + a_to),
+                       std::make_move_iterator(source + b_begin + (from - a_from)), std::make_move_iterator(source + b_begin + (to - a_to)),
+                       target + a_begin + from, comp);
+        };
+        if (in_scratch) {
+            find_splits(scratch);
+        } else {
+            find_splits(first);
+        }
+        size_t tasks = merges * pieces + (run_count % 2);
+        detail::for_each_block(job_ngin, tasks, type, [&](size_t task) {
+            if (in_scratch) {
+                merge_piece(scratch, first, task);
+            } else {
+                merge_piece(first, scratch, task);
+            }
+        });
+        in_scratch = !in_scratch;
+
+        std::vector<size_t> merged;
+        for (size_t run = 0; run < run_count; run += 2) {
+            merged.push_back(runs[run]);
+        }
+        merged.push_back(count);
+        runs = std::move(merged);
+    }
+
+    if (in_scratch) {
+        detail::for_each_block(job_ngin, blocks, type, [&](size_t block) {
+            size_t block_begin = detail::algorithm_block_begin(count, blocks, block);
+            size_t block_end = detail::algorithm_block_begin(count, blocks, block + 1);
+            std::move(scratch + block_begin, scratch + block_end, first + block_begin);
+        });
+    }
+}
+
+/**
+ * @brief Sorts `items` by the 64-bit key `key(item)`, ascending: a stable LSD radix sort.
+ *
+ * Eight passes of one byte each. In a pass every block counts its digits, the counts are
+ * turned into per-block output offsets, and every block scatters its items in order, which
+ * keeps the sort stable. Passes on a byte that is the same in every key are skipped, so
+ * small or clustered keys (draw keys with unused high bits, say) cost fewer passes.
+ * Needs a scratch buffer of `count` items; T must be default-constructible and movable.
+ */
+template<typename T, typename KeyFn>
+void parallel_radix_sort(JobNgin& job_ngin, T* items, size_t count, KeyFn key, JobType type = JobType::Other) {
+    static constexpr size_t PASSES = 8;
+    static constexpr size_t RADIX = 256;
+    using Counts = std::array<size_t, RADIX>;
+    if (count < 2) {
+        return;
+    }
+    size_t blocks = detail::algorithm_block_count(job_ngin, count, 0);
+    auto block_begin = [&](size_t block) {
+        return detail::algorithm_block_begin(count, blocks, block);
+    };
+
+    // One read of the input finds the bytes worth sorting on.
+    std::vector<std::array<Counts, PASSES>> block_digits(blocks);
+    detail::for_each_block(job_ngin, blocks, type, [&](size_t block) {
+        std::array<Counts, PASSES>& digits = block_digits[block];
+        for (Counts& counts : digits) {
+            counts.fill(0);
+        }
+        for (size_t i = block_begin(block), end = block_begin(block + 1); i < end; ++i) {
+            uint64_t k = static_cast<uint64_t>(key(items[i]));
+            for (size_t pass = 0; pass < PASSES; ++pass) {
+                ++digits[pass][(k >> (pass * 8)) & 0xFF];
+            }
+        }
+    });
+    std::vector<size_t> passes;
+    for (size_t pass = 0; pass < PASSES; ++pass) {
+        for (size_t digit = 0; digit < RADIX; ++digit) {
+            size_t total = 0;
+            for (const auto& digits : block_digits) {
+                total += digits[pass][digit];
+            }
+            if (total != 0) {
+                if (total != count) {
+                    passes.push_back(pass);
+                }
+                break;
+            }
+        }
+    }
+    if (passes.empty()) {
+        return;
+    }
+
+    std::vector<T> buffer(count);
+    T* source = items;
+    T* target = buffer.data();
+    std::vector<Counts> offsets(blocks);
+    for (size_t pass : passes) {
+        unsigned int shift = static_cast<unsigned int>(pass * 8);
+        // The counts from the first read still hold for the first pass; later passes recount
+        // since the items have moved between blocks.
+        if (pass != passes.front()) {
+            detail::for_each_block(job_ngin, blocks, type, [&](size_t block) {
+                Counts& counts = block_digits[block][pass];
+                counts.fill(0);
+                for (size_t i = block_begin(block), end = block_begin(block + 1); i < end; ++i) {
+                    ++counts[(static_cast<uint64_t>(key(source[i])) >> shift) & 0xFF];
+                }
+            });
+        }
+        size_t next = 0;
+        for (size_t digit = 0; digit < RADIX; ++digit) {
+            for (size_t block = 0; block < blocks; ++block) {
+                offsets[block][digit] = next;
+                next += block_digits[block][pass][digit];
+            }
+        }
+        detail::for_each_block(job_ngin, blocks, type, [&](size_t block) {
+            Counts& cursor = offsets[block];
+            for (size_t i = block_begin(block), end = block_begin(block + 1); i < end; ++i) {
+                size_t digit = (static_cast<uint64_t>(key(source[i])) >> shift) & 0xFF;
+                target[cursor[digit]++] = std::move(source[i]);
+            }
+        });
+        std::swap(source, target);
+    }
+
+    if (source != items) {
+        detail::for_each_block(job_ngin, blocks, type, [&](size_t block) {
+            std::move(source + block_begin(block), source + block_begin(block + 1), items + block_begin(block));
+        });
+    }
+}
+
+// Sorts 64-bit keys ascending with parallel_radix_sort.
+inline void parallel_radix_sort(JobNgin& job_ngin, uint64_t* keys, size_t count, JobType type = JobType::Other) {
+    parallel_radix_sort(job_ngin, keys, count, [](uint64_t key) {
+        return key;
+    }, type);
+}
+
+}
+}
+
+#endif // JOB_ALGORITHM_H
@@ -0,0 +1,162 @@
+#ifndef JOB_ARENA_H
+#define JOB_ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ngin {
+namespace jobs {
+
+/**
+ * @brief A linear bump allocator for scratch memory that lives for one frame.
+ *
+ * Allocation is a pointer bump; nothing is freed individually. reset() releases
+ * everything at once. When a frame needed more than the first chunk, the chunks are
+ * merged into one large enough for the whole frame, so after a frame or two of
+ * warm-up an arena never touches the heap again.
+ *
+ * Not thread-safe: each thread owns its own arena (see JobNgin::frame_arena).
+ * Destructors of objects placed in the arena are never run.
+ */
+class FrameArena {
+public:
+    explicit FrameArena(size_t initial_size = 64 * 1024)
+        : chunk_size_(std::max<size_t>(initial_size, 64)) {}
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /**
+     * @brief Returns `size` bytes aligned to `alignment`, a power of two.
+     * The memory stays valid until the next reset().
+     */
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        uintptr_t aligned = (cursor_ + alignment - 1) & ~(uintptr_t(alignment) - 1);
+        if (aligned + size > end_ || end_ == 0) {
+            add_chunk_(size + alignment);
+            aligned = (cursor_ + alignment - 1) & ~(uintptr_t(alignment) - 1);
+        }
+        cursor_ = aligned + size;
+        used_ += size;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    // Constructs a T in the arena. T must be trivially destructible, since it is never destroyed.
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "FrameArena never runs destructors");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // Allocates `count` default-initialized Ts.
+    template<typename T>
+    T* allocate_array(size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "FrameArena never runs destructors");
+        T* items = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        for (size_t i = 0; i < count; ++i) {
+            new (items + i) T;
+        }
+        return items;
+    }
+
+    // Releases every allocation, keeping the memory for the next frame.
+    void reset() {
+        if (chunks_.size() > 1) {
+            size_t total = 0;
+            for (const Chunk& chunk : chunks_) {
+                total += chunk.size;
+            }
+            chunks_.clear();
+            chunk_size_ = total;
+        }
+        if (chunks_.empty()) {
+            cursor_ = end_ = 0;
+        } else {
+            cursor_ = reinterpret_cast<uintptr_t>(chunks_.front().data.get());
+            end_ = cursor_ + chunks_.front().size;
+        }
+        used_ = 0;
+    }
+
+    // Bytes handed out since the last reset.
+    size_t bytes_used() const {
+        return used_;
+    }
+
+    // Bytes currently held, used or not.
+    size_t capacity() const {
+        size_t total = 0;
+        for (const Chunk& chunk : chunks_) {
+            total += chunk.size;
+        }
+        return total;
+    }
+
+private:
+    struct Chunk {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+    void add_chunk_(size_t min_size) {
+        size_t size = std::max(min_size, chunks_.empty() ? chunk_size_ : chunks_.back().size * 2);
+        chunks_.push_back(Chunk{std::unique_ptr<std::byte[]>(new std::byte[size]), size});
+        cursor_ = reinterpret_cast<uintptr_t>(chunks_.back().data.get());
+        end_ = cursor_ + size;
+    }
+
+    std::vector<Chunk> chunks_;
+    size_t chunk_size_;     // Size of the first chunk allocated after a reset
+    uintptr_t cursor_ = 0;  // Next free byte in the current chunk; 0 before the first chunk
+    uintptr_t end_ = 0;
+    size_t used_ = 0;
+};
+
+/**
+ * @brief A standard allocator drawing from a FrameArena, e.g. for a per-frame std::vector.
+ * deallocate is a no-op; the memory returns to the arena when it resets.
+ */
+template<typename T>
+class FrameAllocator {
+public:
+    using value_type = T;
+
+    explicit FrameAllocator(FrameArena& arena) noexcept : arena_(&arena) {}
+
+    template<typename U>
+    FrameAllocator(const FrameAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(arena_->allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    void deallocate(T*, size_t) noexcept {}
+
+    FrameArena* arena() const noexcept {
+        return arena_;
+    }
+
+    template<typename U>
+    bool operator==(const FrameAllocator<U>& other) const noexcept {
+        return arena_ == other.arena();
+    }
+
+    template<typename U>
+    bool operator!=(const FrameAllocator<U>& other) const noexcept {
+        return arena_ != other.arena();
+    }
+
+private:
+    FrameArena* arena_;
+};
+
+}
+}
+
+#endif // JOB_ARENA_H
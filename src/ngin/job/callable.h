@@ -0,0 +1,125 @@
+#ifndef JOB_CALLABLE_H
+#define JOB_CALLABLE_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ngin {
+namespace jobs {
+
+/**
+ * @brief A move-only `void()` callable with fixed inline storage.
+ *
+ * Callables up to CAPACITY bytes (lambdas capturing a handful of pointers or
+ * indices, or a whole std::function) are stored in place, so wrapping them
+ * never touches the heap. Larger callables still work but are boxed on the heap.
+ */
+class InlineCallable {
+public:
+    static constexpr size_t CAPACITY = 64;
+
+    InlineCallable() = default;
+
+    template<typename Fn, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Fn>, InlineCallable>>>
+    InlineCallable(Fn&& fn) {
+        assign(std::forward<Fn>(fn));
+    }
+
+    InlineCallable(InlineCallable&& other) noexcept {
+        move_from_(other);
+    }
+
+    InlineCallable& operator=(InlineCallable&& other) noexcept {
+        if (this != &other) {
+            reset();
+            move_from_(other);
+        }
+        return *this;
+    }
+
+    InlineCallable(const InlineCallable&) = delete;
+    InlineCallable& operator=(const InlineCallable&) = delete;
+
+    ~InlineCallable() {
+        reset();
+    }
+
+    // Replaces the stored callable.
+    template<typename Fn>
+    void assign(Fn&& fn) {
+        using F = std::decay_t<Fn>;
+        reset();
+        if constexpr (fits_inline<F>) {
+            ::new (static_cast<void*>(storage_)) F(std::forward<Fn>(fn));
+            ops_ = &inline_ops<F>;
+        } else {
+            ::new (static_cast<void*>(storage_)) F*(new F(std::forward<Fn>(fn)));
+            ops_ = &heap_ops<F>;
+        }
+    }
+
+    void operator()() {
+        ops_->invoke(storage_);
+    }
+
+    explicit operator bool() const {
+        return ops_ != nullptr;
+    }
+
+    // Destroys the stored callable, leaving this empty.
+    void reset() {
+        if (ops_) {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+    // True if a callable of type F is stored without a heap allocation.
+    template<typename F>
+    static constexpr bool fits_inline = sizeof(F) <= CAPACITY
+        && alignof(F) <= alignof(std::max_align_t)
+        && std::is_nothrow_move_constructible_v<F>;
+
+private:
+    struct Ops {
+        void (*invoke)(void* storage);
+        void (*move)(void* dst, void* src); // Move-constructs into dst and destroys src
+        void (*destroy)(void* storage);
+    };
+
+    template<typename F>
+    static constexpr Ops inline_ops = {
+        [](void* storage) { (*std::launder(static_cast<F*>(storage)))(); },
+        [](void* dst, void* src) {
+            F* from = std::launder(static_cast<F*>(src));
+            ::new (dst) F(std::move(*from));
+            from->~F();
+        },
+        [](void* storage) { std::launder(static_cast<F*>(storage))->~F(); }
+    };
+
+    template<typename F>
+    static constexpr Ops heap_ops = {
+        [](void* storage) { (**std::launder(static_cast<F**>(storage)))(); },
+        [](void* dst, void* src) { ::new (dst) F*(*std::launder(static_cast<F**>(src))); },
+        [](void* storage) { delete *std::launder(static_cast<F**>(storage)); }
+    };
+
+    void move_from_(InlineCallable& other) {
+        if (other.ops_) {
+            other.ops_->move(storage_, other.storage_);
+            ops_ = other.ops_;
+            other.ops_ = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage_[CAPACITY];
+    const Ops* ops_ = nullptr;
+};
+
+}
+}
+
+#endif // JOB_CALLABLE_H
@@ -0,0 +1,215 @@
+#ifndef PARALLEL_DEQUE_H
+#define PARALLEL_DEQUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ngin {
+namespace jobs {
+
+/**
+ * @brief A lock-free, growable Chase-Lev work-stealing deque of pointers.
+ *
+ * Only the owning thread may call push() and pop(), which work on the bottom
+ * end of the deque. Any thread may call steal() or steal_batch(), which take from the top end.
+ * The implementation follows Le, Pop, Cohen & Zappa Nardelli,
+ * "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+ *
+ * Buffers replaced by a grow are retired rather than freed, because a thief
+ * may still be reading from them; they are released when the deque is destroyed.
+ *
+ * steal_batch() claims several items with one CAS on the top index. To keep that safe
+ * the owner pops the newest item without a CAS only while at least max_steal_batch()
+ * items sit above it, out of reach of any batch in flight; closer to the top it takes
+ * the oldest item under the same CAS as thieves. With the default batch limit of 1 this
+ * is the plain Chase-Lev deque.
+ *
+ * @tparam T The pointee type. The deque never owns the pointed-to objects.
+ */
+template<typename T>
+class ParallelDeque {
+public:
+    explicit ParallelDeque(int64_t initial_capacity = 256)
+        : top_(0), bottom_(0), buffer_(new Buffer(round_up_pow2(initial_capacity))) {}
+
+    ~ParallelDeque() {
+        delete buffer_.load(std::memory_order_relaxed);
+        for (Buffer* buffer : retired_buffers_) {
+            delete buffer;
+        }
+    }
+
+    ParallelDeque(const ParallelDeque&) = delete;
+    ParallelDeque& operator=(const ParallelDeque&) = delete;
+
+    // Most items one steal_batch() may take; also what a batch buffer must hold.
+    static constexpr size_t MAX_STEAL_BATCH = 64;
+
+    // Sets how many items one steal_batch() may take, clamped to [1, MAX_STEAL_BATCH].
+    // Call before the deque is shared.
+    void set_max_steal_batch(size_t max_batch) {
+        max_steal_batch_ = static_cast<int64_t>(std::clamp<size_t>(max_batch, 1, MAX_STEAL_BATCH));
+    }
+
+    size_t max_steal_batch() const {
+        return static_cast<size_t>(max_steal_batch_);
+    }
+
+    /**
+     * @brief Pushes an item onto the bottom of the deque. Owner thread only.
+     * @param item The item to push.
+     */
+    void push(T* item) {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_acquire);
+        Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+        if (b - t > buffer->capacity - 1) {
+            buffer = grow_(buffer, t, b);
+        }
+        buffer->put(b, item);
+        bottom_.store(b + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Pops the most recently pushed item from the bottom. Owner thread only.
+     * Within max_steal_batch() items of the top it takes the oldest item instead (see above).
+     * @return The item, or nullptr if the deque was empty.
+     */
+    T* pop() {
+        while (true) {
+            int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+            Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+            bottom_.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = top_.load(std::memory_order_relaxed);
+
+            if (t > b) {
+                // Empty: restore bottom.
+                bottom_.store(b + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            if (b - t >= max_steal_batch_) {
+                return buffer->get(b); // No batch claimed from top_ can reach this far.
+            }
+
+            // Within reach of a batch steal: race thieves for the top item instead.
+            T* item = buffer->get(t);
+            bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            if (won) {
+                return item;
+            }
+        }
+    }
+
+    /**
+     * @brief Steals the oldest item from the top of the deque. Safe from any thread.
+     * @return The item, or nullptr if the deque was empty or the steal lost a race.
+     */
+    T* steal() {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom_.load(std::memory_order_acquire);
+
+        if (t >= b) {
+            return nullptr;
+        }
+
+        Buffer* buffer = buffer_.load(std::memory_order_acquire);
+        T* item = buffer->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    /**
+     * @brief Steals up to half of the deque, oldest first, claimed with a single CAS on top_.
+     * Safe from any thread.
+     * @param items Receives the stolen items; must hold `max` of them.
+     * @param max Most items to take; further capped by max_steal_batch().
+     * @return The number of items stolen, 0 if the deque was empty or the steal lost a race.
+     */
+    size_t steal_batch(T** items, size_t max) {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom_.load(std::memory_order_acquire);
+
+        if (t >= b || max == 0) {
+            return 0;
+        }
+
+        int64_t count = std::min({(b - t + 1) / 2, max_steal_batch_, static_cast<int64_t>(max)});
+        Buffer* buffer = buffer_.load(std::memory_order_acquire);
+        for (int64_t i = 0; i < count; ++i) {
+            items[i] = buffer->get(t + i);
+        }
+        if (!top_.compare_exchange_strong(t, t + count, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return 0;
+        }
+        return static_cast<size_t>(count);
+    }
+
+    /**
+     * @brief Approximate number of items. Exact only when no other thread is active.
+     */
+    size_t size() const {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+private:
+    struct Buffer {
+        int64_t capacity;
+        int64_t mask;
+        std::atomic<T*>* items;
+
+        explicit Buffer(int64_t cap) : capacity(cap), mask(cap - 1), items(new std::atomic<T*>[cap]) {}
+        ~Buffer() { delete[] items; }
+
+        T* get(int64_t index) const {
+            return items[index & mask].load(std::memory_order_relaxed);
+        }
+        void put(int64_t index, T* item) {
+            items[index & mask].store(item, std::memory_order_relaxed);
+        }
+    };
+
+    Buffer* grow_(Buffer* old_buffer, int64_t t, int64_t b) {
+        Buffer* new_buffer = new Buffer(old_buffer->capacity * 2);
+        for (int64_t i = t; i < b; ++i) {
+            new_buffer->put(i, old_buffer->get(i));
+        }
+        retired_buffers_.push_back(old_buffer);
+        buffer_.store(new_buffer, std::memory_order_release);
+        return new_buffer;
+    }
+
+    static int64_t round_up_pow2(int64_t value) {
+        int64_t capacity = 2;
+        while (capacity < value) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    // Thieves hammer top_ while the owner works on bottom_; keep them on separate lines.
+    alignas(64) std::atomic<int64_t> top_;
+    alignas(64) std::atomic<int64_t> bottom_;
+    alignas(64) std::atomic<Buffer*> buffer_;
+    std::vector<Buffer*> retired_buffers_; // Owner-only.
+    int64_t max_steal_batch_ = 1;           // Fixed once the deque is shared
+};
+
+}
+}
+
+#endif // PARALLEL_DEQUE_H
@@ -0,0 +1,62 @@
+#ifndef PARALLEL_INBOX_H
+#define PARALLEL_INBOX_H
+
+#include <atomic>
+
+namespace ngin {
+namespace jobs {
+
+/**
+ * @brief A lock-free, intrusive multi-producer inbox.
+ *
+ * Producers push single items or pre-linked chains with one CAS. Consumers take
+ * the whole contents at once with a single exchange, which makes the inbox safe
+ * for any number of consumers without ABA concerns.
+ *
+ * @tparam T The item type. Must expose a `T* next` member used for linking.
+ */
+template<typename T>
+class ParallelInbox {
+public:
+    ParallelInbox() : head_(nullptr) {}
+
+    ParallelInbox(const ParallelInbox&) = delete;
+    ParallelInbox& operator=(const ParallelInbox&) = delete;
+
+    void push(T* item) {
+        push_chain(item, item);
+    }
+
+    /**
+     * @brief Pushes a chain of items linked through `next`, first to last, in one publish.
+     */
+    void push_chain(T* first, T* last) {
+        T* head = head_.load(std::memory_order_relaxed);
+        do {
+            last->next = head;
+        } while (!head_.compare_exchange_weak(head, first, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief Takes every item currently in the inbox.
+     * @return The most recently pushed item, linked through `next` to older ones; nullptr if empty.
+     */
+    T* take_all() {
+        if (head_.load(std::memory_order_relaxed) == nullptr) {
+            return nullptr;
+        }
+        return head_.exchange(nullptr, std::memory_order_acquire);
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    alignas(64) std::atomic<T*> head_;
+};
+
+}
+}
+
+#endif // PARALLEL_INBOX_H
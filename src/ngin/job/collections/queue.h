@@ -6,22 +6,39 @@
 #include <functional>
 #include <thread>
 #include <mutex>
-#include <condition_variable>
 #include <atomic>
 #include <memory>
 #include <map>
+#include <new>
 #include <string>
+#include <cstddef>
+#include <cstdint>
 
 namespace ngin {
 namespace jobs {
 
-// --- Utility: Basic ParallelQueue (Included here for self-containment if not elsewhere) ---
+/**
+ * @brief A FIFO queue any number of threads may push to and pop from.
+ *
+ * With the default Capacity of 0 it is an unbounded std::queue behind a mutex. A non-zero
+ * Capacity, a power of two, selects a bounded lock-free ring instead (see below), for queues
+ * hot enough that the lock shows up; both offer the same interface.
+ */
+template<typename T, size_t Capacity = 0>
+class ParallelQueue;
+
 template<typename T>
-class ParallelQueue {
+class ParallelQueue<T, 0> {
 public:
     void push(T item) {
-        { std::lock_guard<std::mutex> lock(m_mutex_); m_queue_.push(std::move(item)); }
-        m_cv_.notify_one();
+        std::lock_guard<std::mutex> lock(m_mutex_);
+        m_queue_.push(std::move(item));
+    }
+
+    // Same as push; the queue is unbounded, so it never fails.
+    bool try_push(T item) {
+        push(std::move(item));
+        return true;
     }
 
     /**
@@ -48,7 +65,7 @@ public:
         std::lock_guard<std::mutex> lock(m_mutex_);
         return m_queue_.empty();
     }
-    
+
     // NEW: Returns the current size of the queue.
     size_t size() const {
         std::lock_guard<std::mutex> lock(m_mutex_);
@@ -63,10 +80,174 @@ public:
 private:
     std::queue<T> m_queue_;
     mutable std::mutex m_mutex_;
-    std::condition_variable m_cv_;
+};
+
+/**
+ * @brief A bounded lock-free ring of Capacity items, after Dmitry Vyukov's MPMC queue.
+ *
+ * Every cell carries a sequence number saying whose turn it is: a producer may fill cell
+ * `pos % Capacity` once its sequence equals `pos`, a consumer may empty it once it equals
+ * `pos + 1`. A push or pop is thus one CAS on the shared enqueue or dequeue position plus
+ * a release store to the cell, and producers and consumers only meet on cells, never on a
+ * lock. pop_all claims every ready item with a single CAS.
+ *
+ * try_push fails when the ring is full; push then yields until a consumer makes room, so
+ * size the ring for the worst burst between drains.
+ */
+template<typename T, size_t Capacity>
+class ParallelQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "ParallelQueue capacity must be a power of two");
+
+public:
+    ParallelQueue() : cells_(new Cell[Capacity]) {
+        for (size_t i = 0; i < Capacity; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ParallelQueue(const ParallelQueue&) = delete;
+    ParallelQueue& operator=(const ParallelQueue&) = delete;
+
+    ~ParallelQueue() {
+        clear();
+    }
+
+    void push(T item) {
+        while (!try_push(std::move(item))) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Queues `item` unless the ring is full. `item` is only moved from on success.
+    bool try_push(T&& item) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & MASK];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // The cell still holds the item from a lap ago: full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed); // Another producer took it
+            }
+        }
+        new (cell->storage) T(std::move(item));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& item) {
+        T copy(item);
+        return try_push(std::move(copy));
+    }
+
+    bool try_pop(T& item) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & MASK];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // Not filled yet: empty, or its producer is still writing it
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        item = take_(*cell, pos);
+        return true;
+    }
+
+    /**
+     * @brief Moves every item ready at the head into `items`.
+     * Counts the run of filled cells from the head, then claims all of them with one CAS.
+     * Stops at a cell whose producer is still writing it; what follows waits for the next call.
+     */
+    void pop_all(std::vector<T>& items) {
+        size_t pos;
+        size_t ready = claim_ready_(pos);
+        items.reserve(items.size() + ready);
+        for (size_t i = 0; i < ready; ++i) {
+            items.push_back(take_(cells_[(pos + i) & MASK], pos + i));
+        }
+    }
+
+    // Approximate while other threads are pushing or popping.
+    bool empty() const {
+        return size() == 0;
+    }
+
+    // Approximate while other threads are pushing or popping.
+    size_t size() const {
+        size_t dequeued = dequeue_pos_.load(std::memory_order_relaxed);
+        size_t enqueued = enqueue_pos_.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    // Destroys every item ready at the head in place, claimed as pop_all claims them.
+    void clear() {
+        size_t pos;
+        size_t ready = claim_ready_(pos);
+        for (size_t i = 0; i < ready; ++i) {
+            Cell& cell = cells_[(pos + i) & MASK];
+            std::launder(reinterpret_cast<T*>(cell.storage))->~T();
+            cell.sequence.store(pos + i + Capacity, std::memory_order_release);
+        }
+    }
+
+    static constexpr size_t capacity() {
+        return Capacity;
+    }
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    // Claims the run of filled cells at the head with one CAS; sets `pos` to its first position.
+    // Returns the number claimed, 0 if the head cell is not filled yet.
+    size_t claim_ready_(size_t& pos) {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+        size_t ready;
+        do {
+            ready = 0;
+            while (ready < Capacity && cells_[(pos + ready) & MASK].sequence.load(std::memory_order_acquire) == pos + ready + 1) {
+                ++ready;
+            }
+            if (ready == 0) {
+                return 0;
+            }
+        } while (!dequeue_pos_.compare_exchange_weak(pos, pos + ready, std::memory_order_relaxed));
+        return ready;
+    }
+
+    // Moves the item out of a cell claimed at `pos` and hands the cell to the producer one lap on.
+    T take_(Cell& cell, size_t pos) {
+        T* stored = std::launder(reinterpret_cast<T*>(cell.storage));
+        T item(std::move(*stored));
+        stored->~T();
+        cell.sequence.store(pos + Capacity, std::memory_order_release);
+        return item;
+    }
+
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<size_t> enqueue_pos_{0}; // Next position a producer claims
+    alignas(64) std::atomic<size_t> dequeue_pos_{0}; // Next position a consumer claims
 };
 
 }
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,155 @@
+#ifndef JOB_COUNTER_H
+#define JOB_COUNTER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <ngin/job/callable.h>
+
+namespace ngin {
+namespace jobs {
+
+// A callback parked on a counter until it drains, linked in a per-counter list.
+struct JobContinuation {
+    InlineCallable fn;
+    JobContinuation* next = nullptr;
+};
+
+/**
+ * @brief One pooled completion counter, padded to its own cache line.
+ *
+ * `state` packs the generation in its high 32 bits, a cancelled flag in bit 31 and the
+ * pending job count below it, so a handle's generation, completion and cancellation
+ * checks are all one load.
+ * The generation is bumped when the count drains to zero, which is also when the
+ * counter goes back to the pool; handles still holding the old generation then read
+ * as complete instead of aliasing whoever reuses the slot.
+ */
+struct alignas(64) JobCounter {
+    std::atomic<uint64_t> state{0};
+    std::atomic<bool> locked{false};           // Guards continuations against a concurrent drain
+    JobContinuation* continuations = nullptr;
+    std::atomic<uint32_t> next_free{0};        // Free-list link while the counter is unused
+
+    static constexpr uint32_t CANCELLED = 1u << 31;
+
+    static uint32_t generation_of(uint64_t state) { return static_cast<uint32_t>(state >> 32); }
+    static uint32_t count_of(uint64_t state) { return static_cast<uint32_t>(state) & ~CANCELLED; }
+    static bool cancelled(uint64_t state) { return (static_cast<uint32_t>(state) & CANCELLED) != 0; }
+    static uint64_t pack(uint32_t generation, uint32_t count) { return (static_cast<uint64_t>(generation) << 32) | count; }
+
+    void lock() {
+        while (locked.exchange(true, std::memory_order_acquire)) {
+            while (locked.load(std::memory_order_relaxed)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    void unlock() {
+        locked.store(false, std::memory_order_release);
+    }
+};
+
+/**
+ * @brief Process-wide pool of JobCounters addressed by 32-bit index.
+ *
+ * Counters live in fixed-size chunks that are never moved or freed while the pool
+ * exists, so an index stays valid for the lifetime of the process. Index 0 is
+ * reserved for the empty handle. The free list is a lock-free stack whose head
+ * carries a tag to defeat ABA; only growing by a chunk takes a lock.
+ */
+class JobCounterPool {
+public:
+    static constexpr uint32_t CHUNK_SIZE = 4096;
+    static constexpr uint32_t MAX_CHUNKS = 1024;
+
+    static JobCounterPool& instance() {
+        static JobCounterPool pool;
+        return pool;
+    }
+
+    JobCounter& at(uint32_t index) {
+        return chunks_[index / CHUNK_SIZE].load(std::memory_order_acquire)[index % CHUNK_SIZE];
+    }
+
+    // Takes a counter off the free list. Its count is zero and its generation is current.
+    uint32_t acquire() {
+        while (true) {
+            uint64_t head = free_head_.load(std::memory_order_acquire);
+            uint32_t index = static_cast<uint32_t>(head);
+            if (index == 0) {
+                grow_();
+                continue;
+            }
+            uint32_t next = at(index).next_free.load(std::memory_order_relaxed);
+            uint64_t new_head = ((head >> 32) + 1) << 32 | next;
+            if (free_head_.compare_exchange_weak(head, new_head, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                return index;
+            }
+        }
+    }
+
+    void release(uint32_t index) {
+        push_chain_(index, index);
+    }
+
+    ~JobCounterPool() {
+        for (uint32_t i = 0; i < MAX_CHUNKS; ++i) {
+            delete[] chunks_[i].load(std::memory_order_relaxed);
+        }
+    }
+
+private:
+    JobCounterPool() {
+        grow_();
+    }
+
+    void push_chain_(uint32_t first, uint32_t last) {
+        uint64_t head = free_head_.load(std::memory_order_relaxed);
+        while (true) {
+            at(last).next_free.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            uint64_t new_head = ((head >> 32) + 1) << 32 | first;
+            if (free_head_.compare_exchange_weak(head, new_head, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+
+    void grow_() {
+        std::lock_guard<std::mutex> lock(grow_mutex_);
+        if (static_cast<uint32_t>(free_head_.load(std::memory_order_acquire)) != 0) {
+            return; // Another thread refilled the pool while we waited.
+        }
+        if (num_chunks_ == MAX_CHUNKS) {
+            throw std::runtime_error("JobCounterPool: out of job counters");
+        }
+
+        uint32_t chunk = num_chunks_++;
+        JobCounter* counters = new JobCounter[CHUNK_SIZE];
+        uint32_t first = chunk * CHUNK_SIZE;
+        uint32_t last = first + CHUNK_SIZE - 1;
+        for (uint32_t i = 0; i < CHUNK_SIZE - 1; ++i) {
+            counters[i].next_free.store(first + i + 1, std::memory_order_relaxed);
+        }
+        chunks_[chunk].store(counters, std::memory_order_release);
+
+        if (first == 0) {
+            first = 1; // Slot 0 is the empty handle and never circulates.
+        }
+        push_chain_(first, last);
+    }
+
+    std::atomic<uint64_t> free_head_{0}; // Tag in the high 32 bits, first free index in the low 32
+    std::atomic<JobCounter*> chunks_[MAX_CHUNKS] = {};
+    uint32_t num_chunks_ = 0;            // Guarded by grow_mutex_
+    std::mutex grow_mutex_;
+};
+
+}
+}
+
+#endif // JOB_COUNTER_H
@@ -0,0 +1,119 @@
+#ifndef JOB_FIBER_H
+#define JOB_FIBER_H
+
+// Fibers are built on POSIX ucontext and are only enabled on Linux. Elsewhere
+// NGIN_JOB_FIBERS is 0 and JobNgin ignores JobNginOptions::fibers.
+#if defined(__linux__)
+#define NGIN_JOB_FIBERS 1
+#else
+#define NGIN_JOB_FIBERS 0
+#endif
+
+#if NGIN_JOB_FIBERS
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ucontext.h>
+
+#include <ngin/job/handle.h>
+
+namespace ngin {
+namespace jobs {
+
+/**
+ * @brief A cooperatively scheduled execution context with its own stack.
+ *
+ * A fiber is (re)armed with reset() and entered with switch_to(). It never
+ * returns from its entry function; it leaves only by switching to another
+ * context, and a recycled fiber is reset before reuse, so the frames it held
+ * when it was abandoned are never resumed.
+ */
+class Fiber {
+public:
+    using Entry = void (*)(void* arg);
+
+    explicit Fiber(size_t stack_size) : stack_(new char[stack_size]), stack_size_(stack_size) {}
+
+    Fiber(const Fiber&) = delete;
+    Fiber& operator=(const Fiber&) = delete;
+
+    // Arms the fiber to start `entry(arg)` from the top of its stack on the next switch into it.
+    void reset(Entry entry, void* arg) {
+        entry_ = entry;
+        arg_ = arg;
+        getcontext(&context_);
+        context_.uc_stack.ss_sp = stack_.get();
+        context_.uc_stack.ss_size = stack_size_;
+        context_.uc_link = nullptr;
+        // makecontext only forwards int arguments; a 64-bit pointer is split in two.
+        uintptr_t self = reinterpret_cast<uintptr_t>(this);
+        if constexpr (sizeof(void*) > 4) {
+            makecontext(&context_, reinterpret_cast<void (*)()>(&Fiber::trampoline_split_), 2,
+                        static_cast<unsigned int>(static_cast<uint64_t>(self) >> 32), static_cast<unsigned int>(self & 0xffffffffu));
+        } else {
+            makecontext(&context_, reinterpret_cast<void (*)()>(&Fiber::trampoline_), 1, static_cast<unsigned int>(self));
+        }
+    }
+
+    // Saves the running context into `from` and continues this fiber.
+    void switch_to(ucontext_t& from) {
+        swapcontext(&from, &context_);
+    }
+
+    ucontext_t& context() {
+        return context_;
+    }
+
+    Fiber* next = nullptr; // Free-list link
+
+private:
+    static void trampoline_(unsigned int self) {
+        Fiber* fiber = reinterpret_cast<Fiber*>(static_cast<uintptr_t>(self));
+        fiber->entry_(fiber->arg_);
+    }
+
+    static void trampoline_split_(unsigned int high, unsigned int low) {
+        Fiber* fiber = reinterpret_cast<Fiber*>(static_cast<uintptr_t>((static_cast<uint64_t>(high) << 32) | low));
+        fiber->entry_(fiber->arg_);
+    }
+
+    std::unique_ptr<char[]> stack_;
+    size_t stack_size_;
+    ucontext_t context_;
+    Entry entry_ = nullptr;
+    void* arg_ = nullptr;
+};
+
+/**
+ * @brief Work a fiber hands to whichever context it switches into.
+ *
+ * A fiber cannot safely publish itself (as parked or free) before it has actually
+ * stopped running, so it records the request here and the context it switched to
+ * carries it out first thing.
+ */
+struct FiberSwitch {
+    enum class Action {
+        None,
+        Park,    // Resume `fiber` once `handle` completes
+        Recycle  // Return `fiber` to the free pool
+    };
+
+    Action action = Action::None;
+    Fiber* fiber = nullptr;
+    JobHandle handle;
+};
+
+// Per worker thread fiber state.
+struct FiberThread {
+    ucontext_t thread_context;  // The worker thread's own stack, returned to at shutdown
+    Fiber* current = nullptr;   // The fiber this thread is running
+    FiberSwitch pending;
+};
+
+}
+}
+
+#endif // NGIN_JOB_FIBERS
+
+#endif // JOB_FIBER_H
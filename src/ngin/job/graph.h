@@ -0,0 +1,285 @@
+#ifndef JOB_GRAPH_H
+#define JOB_GRAPH_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <ngin/job/ngin.h>
+
+namespace ngin {
+namespace jobs {
+
+/**
+ * @brief A fixed graph of per-frame work, declared once and replayed every frame.
+ *
+ * Nodes are single tasks or index ranges; precede() orders one node before another.
+ * compile() flattens the graph: every range is cut into a fixed set of chunks, and every
+ * node's successors are laid out in one array. run() then only resets two counters per node
+ * and queues the root nodes. The last chunk of a node to finish releases each successor whose
+ * predecessors are all done, queuing all of its chunks as one batch. Once the job pool is
+ * warm a frame builds nothing and allocates nothing.
+ *
+ * Chunks are fixed at compile time rather than split on demand as in parallel_for; with
+ * several chunks per worker, stealing still evens out uneven chunks.
+ *
+ * Build and run a graph from one thread. A graph runs once at a time: run() first waits for
+ * the previous run, and so does the destructor.
+ */
+class TaskGraph {
+public:
+    using NodeId = size_t;
+
+    TaskGraph() = default;
+
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    ~TaskGraph() {
+        if (job_ngin_) {
+            job_ngin_->wait_for(frame_);
+        }
+    }
+
+    // Adds a node running `fn()` once per frame.
+    template<typename Fn>
+    NodeId add_task(Fn fn, JobType type = JobType::Other) {
+        return add_node_([fn = std::move(fn)](size_t, size_t) {
+            fn();
+        }, 1, 1, type);
+    }
+
+    /**
+     * @brief Adds a node running `fn` over [0, size) every frame, as parallel_for would.
+     * @param grain Indices per chunk. Pass 0 to cut the range into a few chunks per worker.
+     * @param fn Either `void(size_t index)` or `void(size_t chunk_begin, size_t chunk_end)`.
+     */
+    template<typename Fn>
+    NodeId add_range(size_t size, size_t grain, Fn fn, JobType type = JobType::Other) {
+        return add_node_([fn = std::move(fn)](size_t begin, size_t end) {
+            if constexpr (std::is_invocable_v<Fn&, size_t, size_t>) {
+                fn(begin, end);
+            } else {
+                for (size_t i = begin; i < end; ++i) {
+                    fn(i);
+                }
+            }
+        }, size, grain, type);
+    }
+
+    // Makes `after` start only once `before` has finished, every frame.
+    void precede(NodeId before, NodeId after) {
+        check_node_(before);
+        check_node_(after);
+        nodes_[before].successors.push_back(after);
+        compiled_ = false;
+    }
+
+    // Changes the size of a range node. Takes effect, re-chunked, from the next run().
+    void set_range_size(NodeId node, size_t size) {
+        check_node_(node);
+        nodes_[node].size = size;
+        compiled_ = false;
+    }
+
+    /**
+     * @brief Lays the graph out for replay, chunking ranges for `job_ngin`'s worker count.
+     * run() compiles on its own when the graph has changed; call this up front to keep that
+     * work out of the first frame.
+     * @throws std::runtime_error if the edges form a cycle.
+     */
+    void compile(const JobNgin& job_ngin) {
+        size_t chunk_target = static_cast<size_t>(job_ngin.num_threads()) * 4;
+        chunks_.clear();
+        successors_.clear();
+        roots_.clear();
+        for (Node& node : nodes_) {
+            node.predecessors = 0;
+        }
+        for (NodeId id = 0; id < nodes_.size(); ++id) {
+            Node& node = nodes_[id];
+            size_t grain = node.grain != 0 ? node.grain : std::max<size_t>(1, (node.size + chunk_target - 1) / chunk_target);
+            node.first_chunk = chunks_.size();
+            for (size_t begin = 0; begin < node.size; begin += grain) {
+                chunks_.push_back(Chunk{id, begin, std::min(node.size, begin + grain)});
+            }
+            node.chunk_count = chunks_.size() - node.first_chunk;
+
+            node.first_successor = successors_.size();
+            node.successor_count = node.successors.size();
+            for (NodeId successor : node.successors) {
+                successors_.push_back(successor);
+                ++nodes_[successor].predecessors;
+            }
+        }
+        for (NodeId id = 0; id < nodes_.size(); ++id) {
+            if (nodes_[id].predecessors == 0) {
+                roots_.push_back(id);
+            }
+        }
+        check_acyclic_();
+
+        states_.reset(new NodeState[nodes_.size()]);
+        compiled_ = true;
+    }
+
+    /**
+     * @brief Starts one run of the graph, waiting for the previous one first.
+     * @return A handle that completes once every node has finished.
+     */
+    JobHandle run(JobNgin& job_ngin) {
+        if (job_ngin_) {
+            job_ngin_->wait_for(frame_);
+        }
+        if (!compiled_ || job_ngin_ != &job_ngin) {
+            compile(job_ngin);
+        }
+        job_ngin_ = &job_ngin;
+
+        for (NodeId id = 0; id < nodes_.size(); ++id) {
+            states_[id].waiting.store(nodes_[id].predecessors, std::memory_order_relaxed);
+            states_[id].chunks_left.store(nodes_[id].chunk_count, std::memory_order_relaxed);
+        }
+        frame_.add_pending(static_cast<int>(nodes_.size()));
+        JobHandle frame = frame_;
+        for (NodeId root : roots_) {
+            release_(root);
+        }
+        return frame;
+    }
+
+    size_t node_count() const {
+        return nodes_.size();
+    }
+
+private:
+    struct Node {
+        std::function<void(size_t, size_t)> fn;
+        JobType type;
+        size_t size;
+        size_t grain;                  // Indices per chunk; 0 to derive one when compiling
+        std::vector<NodeId> successors;
+        // Filled in by compile()
+        size_t first_chunk = 0;
+        size_t chunk_count = 0;
+        size_t first_successor = 0;
+        size_t successor_count = 0;
+        int predecessors = 0;
+    };
+
+    // A slice of one range node, run as one job.
+    struct Chunk {
+        NodeId node;
+        size_t begin;
+        size_t end;
+    };
+
+    // Per-run countdowns of one node, on their own cache line since several workers hit them.
+    struct alignas(64) NodeState {
+        std::atomic<int> waiting{0};        // Predecessors yet to finish
+        std::atomic<size_t> chunks_left{0}; // Chunks yet to finish
+    };
+
+    template<typename Fn>
+    NodeId add_node_(Fn&& fn, size_t size, size_t grain, JobType type) {
+        Node node;
+        node.fn = std::forward<Fn>(fn);
+        node.type = type;
+        node.size = size;
+        node.grain = grain;
+        nodes_.push_back(std::move(node));
+        compiled_ = false;
+        return nodes_.size() - 1;
+    }
+
+    void check_node_(NodeId node) const {
+        if (node >= nodes_.size()) {
+            throw std::out_of_range("TaskGraph: no node " + std::to_string(node));
+        }
+    }
+
+    // Kahn's algorithm over the compiled layout: every node must be reachable in topological order.
+    void check_acyclic_() const {
+        std::vector<int> waiting(nodes_.size());
+        for (NodeId id = 0; id < nodes_.size(); ++id) {
+            waiting[id] = nodes_[id].predecessors;
+        }
+        std::vector<NodeId> ready = roots_;
+        size_t visited = 0;
+        while (!ready.empty()) {
+            const Node& node = nodes_[ready.back()];
+            ready.pop_back();
+            ++visited;
+            for (size_t i = 0; i < node.successor_count; ++i) {
+                NodeId successor = successors_[node.first_successor + i];
+                if (--waiting[successor] == 0) {
+                    ready.push_back(successor);
+                }
+            }
+        }
+        if (visited != nodes_.size()) {
+            throw std::runtime_error("TaskGraph: the graph has a cycle");
+        }
+    }
+
+    // Queues every chunk of a node whose predecessors have all finished.
+    void release_(NodeId id) {
+        const Node& node = nodes_[id];
+        if (node.chunk_count == 0) {
+            finish_node_(id);
+            return;
+        }
+        size_t first_chunk = node.first_chunk;
+        // Completion is tracked through chunks_left and frame_; release_ runs on several threads
+        // at once, so each call counts its chunks against a handle of its own.
+        JobHandle chunks;
+        job_ngin_->submit_each(node.chunk_count, [this, first_chunk](size_t i) {
+            run_chunk_(first_chunk + i);
+        }, node.type, chunks);
+    }
+
+    void run_chunk_(size_t index) {
+        const Chunk& chunk = chunks_[index];
+        nodes_[chunk.node].fn(chunk.begin, chunk.end);
+        if (states_[chunk.node].chunks_left.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            finish_node_(chunk.node);
+        }
+    }
+
+    void finish_node_(NodeId id) {
+        const Node& node = nodes_[id];
+        for (size_t i = 0; i < node.successor_count; ++i) {
+            NodeId successor = successors_[node.first_successor + i];
+            if (states_[successor].waiting.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                release_(successor);
+            }
+        }
+        // Complete a copy: once the count drains, run() or the destructor may replace frame_.
+        JobHandle frame = frame_;
+        frame.complete();
+    }
+
+    std::vector<Node> nodes_;
+    bool compiled_ = false;
+
+    // Compiled layout
+    std::vector<Chunk> chunks_;         // Every node's chunks, node by node
+    std::vector<NodeId> successors_;    // Every node's successors, node by node
+    std::vector<NodeId> roots_;         // Nodes without predecessors
+    std::unique_ptr<NodeState[]> states_;
+
+    JobNgin* job_ngin_ = nullptr; // The engine of the last run
+    JobHandle frame_;             // Counts unfinished nodes of the current run
+};
+
+}
+}
+
+#endif // JOB_GRAPH_H
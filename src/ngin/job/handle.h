@@ -1,5 +1,5 @@
 #ifndef JOB_HANDLE_H
-#define JOB_HANDLE_H 
+#define JOB_HANDLE_H
 
 #include <iostream>
 #include <string>
@@ -8,36 +8,166 @@
 #include <tuple>
 #include <memory>
 #include <atomic>
+#include <cstdint>
 
 #include <ngin/debug/logger.h>
+#include <ngin/job/counter.h>
 
+// A lightweight, trivially copyable reference to a pooled completion counter.
+// The empty (default-constructed) handle and any handle whose counter has since
+// drained and been recycled both report complete.
+//
+// A copy refers to the counter its source held at the time of copying; copies do not
+// share later state. Arming an empty or drained handle (add_pending, or passing it to
+// submit) points only that handle at a fresh counter, so a copy taken before then stays
+// complete. Arm a handle first, then hand out copies that must track its jobs.
 class JobHandle {
 
 public:
-    JobHandle() : counter_(std::make_shared<std::atomic<int>>(0)) {
-    }
-    ~JobHandle() {
+    JobHandle() : index_(0), generation_(0) {
     }
 
     bool is_complete() const {
-        return counter_->load(std::memory_order_acquire) == 0;
+        if (index_ == 0) {
+            return true;
+        }
+        uint64_t state = counter_().state.load(std::memory_order_acquire);
+        return ngin::jobs::JobCounter::generation_of(state) != generation_ || ngin::jobs::JobCounter::count_of(state) == 0;
+    }
+
+    // Registers `count` more outstanding jobs. If this handle is empty or already complete,
+    // it is first re-pointed at a fresh counter, so copies taken earlier are unaffected.
+    void add_pending(int count = 1) {
+        if (count <= 0) {
+            return;
+        }
+        if (index_ != 0) {
+            std::atomic<uint64_t>& state = counter_().state;
+            uint64_t current = state.load(std::memory_order_relaxed);
+            while (ngin::jobs::JobCounter::generation_of(current) == generation_ && ngin::jobs::JobCounter::count_of(current) != 0) {
+                if (state.compare_exchange_weak(current, current + static_cast<uint32_t>(count), std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                    return;
+                }
+            }
+        }
+
+        ngin::jobs::JobCounterPool& pool = ngin::jobs::JobCounterPool::instance();
+        index_ = pool.acquire();
+        ngin::jobs::JobCounter& counter = pool.at(index_);
+        generation_ = ngin::jobs::JobCounter::generation_of(counter.state.load(std::memory_order_relaxed));
+        counter.state.store(ngin::jobs::JobCounter::pack(generation_, static_cast<uint32_t>(count)), std::memory_order_release);
+    }
+
+    /**
+     * @brief Marks `count` jobs as finished.
+     * The call that drains the counter runs every registered continuation on the calling thread
+     * and returns the counter to the pool.
+     */
+    void complete(int count = 1) {
+        if (index_ == 0) {
+            return; // The empty handle has no jobs to finish; slot 0 is reserved.
+        }
+        ngin::jobs::JobCounter& counter = counter_();
+        uint64_t previous = counter.state.fetch_sub(static_cast<uint32_t>(count), std::memory_order_acq_rel);
+        if (ngin::jobs::JobCounter::count_of(previous) != static_cast<uint32_t>(count)) {
+            return;
+        }
+
+        counter.lock();
+        ngin::jobs::JobContinuation* ready = counter.continuations;
+        counter.continuations = nullptr;
+        counter.state.store(ngin::jobs::JobCounter::pack(generation_ + 1, 0), std::memory_order_release);
+        counter.unlock();
+        ngin::jobs::JobCounterPool::instance().release(index_);
+
+        while (ready) {
+            ngin::jobs::JobContinuation* next = ready->next;
+            ready->fn();
+            delete ready;
+            ready = next;
+        }
     }
 
-    // This version is for non-const JobHandle objects
-    std::shared_ptr<std::atomic<int>>& get_counter() {
-        return counter_;
+    /**
+     * @brief Runs `continuation` once this handle completes.
+     * If the handle is already complete the continuation runs immediately on the calling thread.
+     */
+    template<typename Fn>
+    void on_complete(Fn&& continuation) {
+        // Only moved from when it is registered, so it is still intact if we must run it here.
+        if (!try_on_complete(std::forward<Fn>(continuation))) {
+            continuation();
+        }
     }
 
-    // ADDED: A const-overload for const JobHandle objects (like in wait_for)
-    const std::shared_ptr<std::atomic<int>>& get_counter() const {
-        return counter_;
+    /**
+     * @brief Registers `continuation` to run once this handle completes, unless it already has.
+     * @return False, without running or keeping the continuation, if the handle is already complete.
+     */
+    template<typename Fn>
+    bool try_on_complete(Fn&& continuation) {
+        if (index_ == 0) {
+            return false;
+        }
+        ngin::jobs::JobCounter& counter = counter_();
+        counter.lock();
+        uint64_t state = counter.state.load(std::memory_order_acquire);
+        if (ngin::jobs::JobCounter::generation_of(state) != generation_ || ngin::jobs::JobCounter::count_of(state) == 0) {
+            counter.unlock();
+            return false;
+        }
+        ngin::jobs::JobContinuation* node = new ngin::jobs::JobContinuation();
+        node->fn.assign(std::forward<Fn>(continuation));
+        node->next = counter.continuations;
+        counter.continuations = node;
+        counter.unlock();
+        return true;
+    }
+
+    /**
+     * @brief Cancels every job counted against this handle that has not started yet.
+     * Such jobs are dropped when a worker dequeues them but still count as finished, so
+     * waiters and continuations run as usual. Jobs already running are not interrupted; a
+     * long job may poll is_cancelled() to stop early. Jobs added later through add_pending,
+     * while the handle is still incomplete, are cancelled too. No effect once complete.
+     */
+    void cancel() {
+        if (index_ == 0) {
+            return;
+        }
+        std::atomic<uint64_t>& state = counter_().state;
+        uint64_t current = state.load(std::memory_order_relaxed);
+        while (ngin::jobs::JobCounter::generation_of(current) == generation_ && ngin::jobs::JobCounter::count_of(current) != 0
+               && !ngin::jobs::JobCounter::cancelled(current)) {
+            if (state.compare_exchange_weak(current, current | ngin::jobs::JobCounter::CANCELLED, std::memory_order_release, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+
+    // True if cancel() was called and the handle has not completed since.
+    bool is_cancelled() const {
+        if (index_ == 0) {
+            return false;
+        }
+        uint64_t state = counter_().state.load(std::memory_order_acquire);
+        return ngin::jobs::JobCounter::generation_of(state) == generation_ && ngin::jobs::JobCounter::cancelled(state);
+    }
+
+    // The counter slot this handle refers to; 0 for the empty handle. Stable for tracing.
+    uint32_t id() const {
+        return index_;
     }
 
 
 private:
-    ngin::debug::Logger* logger_ = nullptr;
-    std::shared_ptr<std::atomic<int>> counter_; 
+    ngin::jobs::JobCounter& counter_() const {
+        return ngin::jobs::JobCounterPool::instance().at(index_);
+    }
+
+    uint32_t index_;      // Slot in JobCounterPool, 0 for the empty handle
+    uint32_t generation_; // Generation of that slot this handle was issued for
 
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,581 @@
+#ifndef JOB_IO_H
+#define JOB_IO_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// POSIX targets read with pread on a file descriptor; elsewhere the reader threads use std::ifstream.
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#define NGIN_JOB_IO_POSIX 1
+#else
+#include <fstream>
+#define NGIN_JOB_IO_POSIX 0
+#endif
+
+#include <ngin/debug/logger.h>
+#include <ngin/job/ngin.h>
+
+// After the ngin headers: <linux/io_uring.h> pulls in <linux/fs.h>, whose BLOCK_SIZE macro
+// would otherwise clobber JobPool::BLOCK_SIZE.
+// Define NGIN_JOB_IO_URING as 0 to always use the reader threads.
+#if !defined(NGIN_JOB_IO_URING) && defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#undef BLOCK_SIZE
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define NGIN_JOB_IO_URING 1
+#endif
+#endif
+#ifndef NGIN_JOB_IO_URING
+#define NGIN_JOB_IO_URING 0
+#endif
+
+namespace ngin {
+namespace jobs {
+
+// The outcome of FileReader::read_file, handed to its continuation.
+struct FileReadResult {
+    std::string path;
+    std::string bytes; // The whole file on success
+    int error = 0;     // errno value, 0 on success
+
+    bool ok() const {
+        return error == 0;
+    }
+};
+
+/**
+ * @brief Reads whole files without blocking JobNgin workers.
+ *
+ * read_file() opens the file on the calling thread and queues the read; the bytes are
+ * fetched in the background and handed to a continuation job on the JobNgin once they
+ * have all arrived. A job can thus start dozens of reads and finish straight away,
+ * leaving its worker free for compute while the disk is kept busy.
+ *
+ * On Linux the reads go through an io_uring driven by raw syscalls, with one thread
+ * reaping completions. Where io_uring is unavailable (older kernels, seccomp filters,
+ * other platforms) a small pool of blocking reader threads is used instead.
+ */
+class FileReader {
+public:
+    enum class Backend {
+        IoUring,
+        ThreadPool
+    };
+
+    /**
+     * @param job_ngin Where continuations run.
+     * @param queue_depth Most reads in flight at once; further reads wait their turn.
+     * @param fallback_threads Reader threads used if io_uring is unavailable.
+     */
+    explicit FileReader(JobNgin& job_ngin, unsigned int queue_depth = 64, unsigned int fallback_threads = 2)
+        : logger_(new ngin::debug::Logger("FileReader")), job_ngin_(job_ngin), queue_depth_(std::max(queue_depth, 1u)) {
+#if NGIN_JOB_IO_URING
+        if (setup_ring_()) {
+            backend_ = Backend::IoUring;
+            reaper_ = std::thread([this]() { reap_loop_(); });
+            logger_->info("Using io_uring with queue depth " + std::to_string(queue_depth_));
+            return;
+        }
+        logger_->warn("io_uring unavailable; falling back to reader threads.");
+#endif
+        backend_ = Backend::ThreadPool;
+        for (unsigned int i = 0; i < std::max(fallback_threads, 1u); ++i) {
+            readers_.emplace_back([this]() { reader_loop_(); });
+        }
+    }
+
+    FileReader(const FileReader&) = delete;
+    FileReader& operator=(const FileReader&) = delete;
+
+    /**
+     * @brief Waits for every read in flight to hand off its continuation, then stops.
+     * The continuations themselves may still be queued on the JobNgin.
+     */
+    ~FileReader() {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            idle_cv_.wait(lock, [this]() { return outstanding_ == 0; });
+            stopping_ = true;
+        }
+#if NGIN_JOB_IO_URING
+        if (backend_ == Backend::IoUring) {
+            // Nothing is in flight, so a refusal can only be a transient shortage; keep trying.
+            while (true) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    io_uring_sqe* sqe = next_sqe_();
+                    sqe->opcode = IORING_OP_NOP;
+                    sqe->user_data = 0; // Tells the reaper to exit
+                    if (submit_sqes_(1)) {
+                        break;
+                    }
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            reaper_.join();
+            teardown_ring_();
+        }
+#endif
+        work_cv_.notify_all();
+        for (std::thread& reader : readers_) {
+            reader.join();
+        }
+        delete logger_;
+    }
+
+    Backend backend() const {
+        return backend_;
+    }
+
+    // The JobNgin continuations run on.
+    JobNgin& job_ngin() const {
+        return job_ngin_;
+    }
+
+    /**
+     * @brief Reads the file at `path` and runs `on_read(FileReadResult&)` as a job once it has.
+     * The continuation also runs, with `error` set, if the file cannot be opened or read.
+     * If `handle` is already cancelled the file is not read at all.
+     * @param path The file to read.
+     * @param on_read The continuation, run on a JobNgin worker.
+     * @param type The type the continuation job is accounted under.
+     * @param handle Completes once the continuation has run, as with JobNgin::submit.
+     */
+    template<typename Fn>
+    void read_file(const std::string& path, Fn&& on_read, JobType type, JobHandle& handle) {
+        handle.add_pending(1);
+        Request* request = new Request{};
+        request->result.path = path;
+        request->on_read = std::forward<Fn>(on_read);
+        request->type = type;
+        request->handle = handle;
+        if (handle.is_cancelled()) {
+            request->result.error = ECANCELED;
+            finish_(request);
+            return;
+        }
+
+        if (!open_(request)) {
+            finish_(request);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++outstanding_;
+            if (in_flight_ < queue_depth_) {
+                start_(request);
+            } else {
+                waiting_.push_back(request);
+            }
+        }
+        retire_failed_();
+    }
+
+private:
+    struct Request {
+        FileReadResult result;
+        std::function<void(FileReadResult&)> on_read;
+        JobType type;
+        JobHandle handle;
+#if NGIN_JOB_IO_POSIX
+        int fd = -1;
+#else
+        std::ifstream file;
+#endif
+        size_t offset = 0; // Bytes read so far
+#if NGIN_JOB_IO_URING
+        iovec io;
+#endif
+    };
+
+    // Opens the request's file and sizes its buffer to match. On failure sets result.error.
+    bool open_(Request* request) {
+        const std::string& path = request->result.path;
+#if NGIN_JOB_IO_POSIX
+        request->fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat info;
+        if (request->fd < 0 || ::fstat(request->fd, &info) != 0) {
+            request->result.error = errno;
+            return false;
+        }
+        request->result.bytes.resize(static_cast<size_t>(info.st_size));
+#else
+        errno = 0;
+        request->file.open(path, std::ios::binary | std::ios::ate);
+        std::streamoff size = request->file ? static_cast<std::streamoff>(request->file.tellg()) : -1;
+        if (size < 0) {
+            request->result.error = errno != 0 ? errno : ENOENT;
+            return false;
+        }
+        request->result.bytes.resize(static_cast<size_t>(size));
+#endif
+        return true;
+    }
+
+    void close_(Request* request) {
+#if NGIN_JOB_IO_POSIX
+        if (request->fd >= 0) {
+            ::close(request->fd);
+            request->fd = -1;
+        }
+#else
+        request->file.close();
+#endif
+    }
+
+    // Sends `request` to the backend. Caller holds mutex_. A read the kernel refuses lands in
+    // failed_, for the caller to pass to retire_failed_ once it has released the lock.
+    void start_(Request* request) {
+        ++in_flight_;
+#if NGIN_JOB_IO_URING
+        if (backend_ == Backend::IoUring) {
+            submit_read_(request);
+            return;
+        }
+#endif
+        work_.push_back(request);
+        work_cv_.notify_one();
+    }
+
+    // Ends a read: releases its slot, lets a waiting read start and hands the result to its continuation.
+    void retire_(Request* request) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --in_flight_;
+            if (!waiting_.empty()) {
+                Request* next = waiting_.front();
+                waiting_.pop_front();
+                start_(next);
+            }
+        }
+        finish_(request);
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--outstanding_ == 0) {
+            idle_cv_.notify_all();
+        }
+    }
+
+    // Retires every read in failed_, including any whose refused successor lands there meanwhile.
+    // Caller must not hold mutex_.
+    void retire_failed_() {
+        while (true) {
+            Request* request;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (failed_.empty()) {
+                    return;
+                }
+                request = failed_.front();
+                failed_.pop_front();
+            }
+            retire_(request);
+        }
+    }
+
+    // Schedules the continuation, then releases the count read_file added to the handle. The job
+    // owns the request, so it is freed even if the continuation is cancelled and never runs.
+    void finish_(Request* request) {
+        close_(request);
+        JobHandle handle = request->handle;
+        job_ngin_.submit([request = std::unique_ptr<Request>(request)]() {
+            request->on_read(request->result);
+        }, request->type, handle);
+        handle.complete();
+    }
+
+    // --- Thread-pool backend ---
+
+    void reader_loop_() {
+        while (true) {
+            Request* request;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                work_cv_.wait(lock, [this]() { return stopping_ || !work_.empty(); });
+                if (work_.empty()) {
+                    return;
+                }
+                request = work_.front();
+                work_.pop_front();
+            }
+            read_all_(request);
+            retire_(request);
+        }
+    }
+
+    // Blocking read of the rest of the request's file into its buffer.
+    void read_all_(Request* request) {
+        std::string& bytes = request->result.bytes;
+#if NGIN_JOB_IO_POSIX
+        while (request->offset < bytes.size()) {
+            ssize_t read = ::pread(request->fd, bytes.data() + request->offset, bytes.size() - request->offset, static_cast<off_t>(request->offset));
+            if (read < 0 && errno == EINTR) {
+                continue;
+            }
+            if (read < 0) {
+                request->result.error = errno;
+                return;
+            }
+            if (read == 0) {
+                bytes.resize(request->offset); // The file shrank since it was opened
+                return;
+            }
+            request->offset += static_cast<size_t>(read);
+        }
+#else
+        request->file.seekg(static_cast<std::streamoff>(request->offset));
+        request->file.read(bytes.data() + request->offset, static_cast<std::streamsize>(bytes.size() - request->offset));
+        request->offset += static_cast<size_t>(request->file.gcount());
+        if (request->offset < bytes.size()) {
+            if (request->file.bad()) {
+                request->result.error = EIO;
+            } else {
+                bytes.resize(request->offset); // The file shrank since it was opened
+            }
+        }
+#endif
+    }
+
+#if NGIN_JOB_IO_URING
+    // --- io_uring backend ---
+
+    bool setup_ring_() {
+        io_uring_params params{};
+        int fd = static_cast<int>(::syscall(__NR_io_uring_setup, queue_depth_, &params));
+        if (fd < 0) {
+            return false;
+        }
+        ring_fd_ = fd;
+
+        sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap) {
+            sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        }
+        sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        cq_ring_ = single_mmap ? sq_ring_ : ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes == MAP_FAILED) {
+            if (sqes != MAP_FAILED) {
+                ::munmap(sqes, sqes_size_);
+            }
+            sqes_ = nullptr;
+            teardown_ring_();
+            return false;
+        }
+
+        char* sq = static_cast<char*>(sq_ring_);
+        char* cq = static_cast<char*>(cq_ring_);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        // Reads are capped at queue_depth_ and the kernel doubles the CQ, so it cannot overflow.
+        return true;
+    }
+
+    void teardown_ring_() {
+        if (sqes_) {
+            ::munmap(sqes_, sqes_size_);
+        }
+        if (cq_ring_ && cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+            ::munmap(cq_ring_, cq_ring_size_);
+        }
+        if (sq_ring_ && sq_ring_ != MAP_FAILED) {
+            ::munmap(sq_ring_, sq_ring_size_);
+        }
+        ::close(ring_fd_);
+    }
+
+    // The next free submission entry, zeroed. Caller holds mutex_. Every entry is submitted as
+    // soon as it is filled, and without SQPOLL the kernel consumes it in io_uring_enter, so the
+    // SQ always has room.
+    io_uring_sqe* next_sqe_() {
+        unsigned tail = *sq_tail_;
+        unsigned index = tail & sq_mask_;
+        io_uring_sqe* sqe = &sqes_[index];
+        *sqe = io_uring_sqe{};
+        sq_array_[index] = index;
+        return sqe;
+    }
+
+    /**
+     * @brief Publishes the last `count` entries from next_sqe_ and enters the kernel. Caller holds mutex_.
+     * Entries the kernel leaves unconsumed are submitted again, backing off briefly while it is
+     * short of resources (EAGAIN, EBUSY).
+     * @return False, with errno set, if the kernel still refuses some entries. Those are withdrawn
+     *         from the SQ, so they never reach the kernel later.
+     */
+    bool submit_sqes_(unsigned count) {
+        __atomic_store_n(sq_tail_, *sq_tail_ + count, __ATOMIC_RELEASE);
+        int retries = 0;
+        while (true) {
+            long submitted = ::syscall(__NR_io_uring_enter, ring_fd_, count, 0, 0, nullptr, 0);
+            if (submitted > 0) {
+                count -= static_cast<unsigned>(std::min<long>(submitted, count));
+                if (count == 0) {
+                    return true;
+                }
+                continue;
+            }
+            int error = submitted < 0 ? errno : EAGAIN;
+            if (error == EINTR) {
+                continue;
+            }
+            if ((error == EAGAIN || error == EBUSY) && retries < SUBMIT_RETRIES) {
+                std::this_thread::sleep_for(std::chrono::microseconds(50 << retries++));
+                continue;
+            }
+            // Without SQPOLL only io_uring_enter consumes entries, and we hold mutex_, so the
+            // unconsumed ones are still the last on the SQ.
+            __atomic_store_n(sq_tail_, *sq_tail_ - count, __ATOMIC_RELEASE);
+            errno = error;
+            return false;
+        }
+    }
+
+    // Queues a read of the rest of `request`'s file. Caller holds mutex_. If the kernel refuses
+    // it, the request moves to failed_ with the error set.
+    void submit_read_(Request* request) {
+        std::string& bytes = request->result.bytes;
+        request->io.iov_base = bytes.data() + request->offset;
+        request->io.iov_len = bytes.size() - request->offset;
+
+        io_uring_sqe* sqe = next_sqe_();
+        sqe->opcode = IORING_OP_READV; // Rather than IORING_OP_READ, which needs Linux 5.6
+        sqe->fd = request->fd;
+        sqe->off = request->offset;
+        sqe->addr = reinterpret_cast<uint64_t>(&request->io);
+        sqe->len = 1;
+        sqe->user_data = reinterpret_cast<uint64_t>(request);
+        if (!submit_sqes_(1)) {
+            request->result.error = errno;
+            failed_.push_back(request);
+        }
+    }
+
+    // Waits for completions and either re-queues short reads or retires finished ones.
+    void reap_loop_() {
+        while (true) {
+            if (::syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR) {
+                // Still reap whatever has arrived, but do not spin on a persistent error.
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+            {
+                // Every request was filled in under mutex_ before it reached the kernel. The kernel
+                // orders that before its completion, but the C++ memory model (and TSan) needs the
+                // lock to see it.
+                std::lock_guard<std::mutex> lock(mutex_);
+            }
+
+            unsigned head = *cq_head_;
+            unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+            std::vector<Request*> done;
+            bool exit = false;
+            for (; head != tail; ++head) {
+                const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+                Request* request = reinterpret_cast<Request*>(cqe.user_data);
+                if (!request) {
+                    exit = true;
+                    continue;
+                }
+                std::string& bytes = request->result.bytes;
+                if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+                    resubmit_(request);
+                } else if (cqe.res < 0) {
+                    request->result.error = -cqe.res;
+                    done.push_back(request);
+                } else if (cqe.res == 0) {
+                    bytes.resize(request->offset); // The file shrank since it was opened
+                    done.push_back(request);
+                } else {
+                    request->offset += static_cast<size_t>(cqe.res);
+                    if (request->offset < bytes.size()) {
+                        resubmit_(request);
+                    } else {
+                        done.push_back(request);
+                    }
+                }
+            }
+            __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+
+            for (Request* request : done) {
+                retire_(request);
+            }
+            retire_failed_(); // Resubmissions, or reads started by retire_, the kernel refused
+            if (exit) {
+                return;
+            }
+        }
+    }
+
+    void resubmit_(Request* request) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        submit_read_(request);
+    }
+
+    static constexpr int SUBMIT_RETRIES = 4; // Backoffs of 50, 100, 200 and 400us before giving up
+
+    int ring_fd_ = -1;
+    void* sq_ring_ = nullptr;
+    void* cq_ring_ = nullptr;
+    size_t sq_ring_size_ = 0;
+    size_t cq_ring_size_ = 0;
+    size_t sqes_size_ = 0;
+    unsigned* sq_tail_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned* sq_array_ = nullptr;
+    io_uring_sqe* sqes_ = nullptr;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+    std::thread reaper_;
+#endif
+
+    ngin::debug::Logger* logger_;
+    JobNgin& job_ngin_;
+    unsigned int queue_depth_;
+    Backend backend_ = Backend::ThreadPool;
+
+    std::mutex mutex_;                 // Guards everything below, and the submission queue
+    std::condition_variable work_cv_;  // Thread-pool readers wait here for work_
+    std::condition_variable idle_cv_;  // The destructor waits here for outstanding_ to drain
+    std::deque<Request*> work_;        // Reads queued for the thread pool
+    std::deque<Request*> waiting_;     // Reads past queue_depth_, started as others finish
+    std::deque<Request*> failed_;      // Reads the kernel refused, awaiting retire_failed_
+    unsigned int in_flight_ = 0;       // Reads handed to the backend
+    size_t outstanding_ = 0;           // Reads started and not yet retired
+    bool stopping_ = false;
+    std::vector<std::thread> readers_;
+};
+
+}
+}
+
+#endif // JOB_IO_H
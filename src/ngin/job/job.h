@@ -4,9 +4,14 @@
 #include <functional> // For std::function
 #include <memory>     // For std::shared_ptr if JobHandle is shared_ptr based
 #include <atomic>     // For atomic operations within JobHandle
+#include <chrono>
+#include <string>
 
 #include <ngin/debug/logger.h> // Assuming this path is correct in your project
 #include <ngin/job/handle.h>   // Include JobHandle definition
+#include <ngin/job/callable.h> // Inline, allocation-free task storage
+
+namespace ngin { namespace jobs { class JobPool; } }
 
 enum class JobType {
     None,
@@ -20,20 +25,84 @@ enum class JobType {
     Other
 };
 
+// Number of JobType values, for tables indexed by type.
+static constexpr size_t JOB_TYPE_COUNT = static_cast<size_t>(JobType::Other) + 1;
+
+// Static helper function to convert JobType enum to a string for logging
+static inline std::string to_string(JobType type) {
+    switch (type) {
+        case JobType::AssetSetup: return "AssetSetup";
+        case JobType::Physics: return "Physics";
+        case JobType::Animation: return "Animation";
+        case JobType::AI: return "AI";
+        case JobType::TransformSync: return "TransformSync";
+        case JobType::RenderCommandGeneration: return "RenderCommandGeneration";
+        case JobType::AssetLoading: return "AssetLoading";
+        case JobType::Other: return "Other";
+        case JobType::None: return "None";
+        default: return "Unknown";
+    }
+}
+
+// Scheduling class of a job. Workers always take queued Critical work before Normal,
+// and Normal before Background, both from their own queues and when stealing.
+enum class JobPriority {
+    Critical,   // Work the current frame cannot finish without
+    Normal,
+    Background  // Streaming and other work that may span frames
+};
+
+static constexpr size_t JOB_PRIORITY_COUNT = static_cast<size_t>(JobPriority::Background) + 1;
+
+// The priority a JobType is scheduled at unless JobNgin is told otherwise.
+static constexpr JobPriority default_job_priority(JobType type) {
+    switch (type) {
+        case JobType::Physics:
+        case JobType::Animation:
+        case JobType::TransformSync:
+        case JobType::RenderCommandGeneration:
+            return JobPriority::Critical;
+        case JobType::AssetLoading:
+            return JobPriority::Background;
+        default:
+            return JobPriority::Normal;
+    }
+}
+
+static inline std::string to_string(JobPriority priority) {
+    switch (priority) {
+        case JobPriority::Critical: return "Critical";
+        case JobPriority::Normal: return "Normal";
+        case JobPriority::Background: return "Background";
+        default: return "Unknown";
+    }
+}
+
+// Deadline of a job that may run however late it is dequeued.
+static constexpr std::chrono::steady_clock::time_point NO_JOB_DEADLINE = std::chrono::steady_clock::time_point::max();
+
 // --- Job Struct ---
 // Represents a single unit of work to be executed by a worker thread.
 // It contains the task, its type, and the handle it contributes to.
-struct Job {
-    std::function<void()> task; // The actual work to perform
-    JobType type;               // The category of this job
-    JobHandle handle;           // The handle this job belongs to (for decrementing its counter)
+// Jobs are fixed-size records handed out and recycled by a JobPool; small tasks
+// are stored inline, so a recycled job never allocates.
+struct alignas(64) Job {
+    ngin::jobs::InlineCallable task;  // The actual work to perform
+    JobType type;                     // The category of this job
+    JobPriority priority;             // The queue lane this job is scheduled in
+    JobHandle handle;                 // The handle this job belongs to (for decrementing its counter)
+    std::chrono::steady_clock::time_point deadline = NO_JOB_DEADLINE; // Dropped unrun if dequeued after this
+    Job* next = nullptr;              // Intrusive link used in inboxes, batches and free lists
+    bool stolen = false;              // Taken from another worker's queue at least once, for steal statistics
+    ngin::jobs::JobPool* pool = nullptr; // The pool this record returns to after execution
 
-    // Default constructor for cases where it's default-constructed (e.g., in a queue)
-    Job() : type(JobType::None) {}
+    // Default constructor for cases where it's default-constructed (e.g., in a pool)
+    Job() : type(JobType::None), priority(JobPriority::Normal) {}
 
     // Constructor to initialize a job
-    Job(std::function<void()> fn, JobType t, JobHandle h)
-        : task(std::move(fn)), type(t), handle(std::move(h)) {}
+    template<typename Fn>
+    Job(Fn&& fn, JobType t, JobHandle h)
+        : task(std::forward<Fn>(fn)), type(t), priority(default_job_priority(t)), handle(std::move(h)) {}
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,128 @@
+#ifndef JOB_MAIN_THREAD_H
+#define JOB_MAIN_THREAD_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include <ngin/job/handle.h>
+
+namespace ngin {
+namespace jobs {
+
+/**
+ * @brief Jobs that only the main thread runs, e.g. OpenGL calls, which need the context
+ * current on that thread.
+ *
+ * Any thread may submit; the main thread runs the queue in submission order, either from
+ * run() once per frame under a time budget or from JobNgin::wait_for while it waits. A job
+ * is counted against a JobHandle like any other, so a worker can hand GPU work back and wait
+ * for it, or chain on it, without knowing when the main thread will get to it.
+ *
+ * A job submitted from the main thread itself is queued too, never run on the spot, so it
+ * cannot run in the middle of whatever the caller is doing.
+ */
+class MainThreadQueue {
+public:
+    // Binds the queue to the constructing thread.
+    MainThreadQueue() : main_thread_(std::this_thread::get_id()) {}
+
+    MainThreadQueue(const MainThreadQueue&) = delete;
+    MainThreadQueue& operator=(const MainThreadQueue&) = delete;
+
+    // Makes the calling thread the one that runs the queue, e.g. when the GL context is created elsewhere.
+    void bind_to_current_thread() {
+        main_thread_.store(std::this_thread::get_id(), std::memory_order_release);
+    }
+
+    bool is_main_thread() const {
+        return main_thread_.load(std::memory_order_acquire) == std::this_thread::get_id();
+    }
+
+    /**
+     * @brief Queues `task` for the main thread, counted against `handle`.
+     * Like any job, it is dropped unrun if `handle` is cancelled before it starts.
+     */
+    template<typename Fn>
+    void submit(Fn&& task, JobHandle& handle) {
+        handle.add_pending(1);
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(Entry{std::function<void()>(std::forward<Fn>(task)), handle});
+        queued_.fetch_add(1, std::memory_order_release);
+    }
+
+    // Queues `task` for the main thread. The returned handle completes once it has run.
+    template<typename Fn>
+    JobHandle submit(Fn&& task) {
+        JobHandle handle;
+        submit(std::forward<Fn>(task), handle);
+        return handle;
+    }
+
+    /**
+     * @brief Runs queued jobs until the queue is empty or `budget` has passed. Main thread only.
+     * At least one job runs if any is queued, so a budget too small for the slowest job still
+     * makes progress; jobs left over wait for the next call.
+     * @return The number of jobs run.
+     */
+    size_t run(std::chrono::steady_clock::duration budget) {
+        std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now() + budget;
+        size_t count = 0;
+        while (run_one()) {
+            ++count;
+            if (std::chrono::steady_clock::now() >= stop) {
+                break;
+            }
+        }
+        return count;
+    }
+
+    // Runs the oldest queued job, if any. Main thread only.
+    bool run_one() {
+        if (queued_.load(std::memory_order_acquire) == 0) {
+            return false; // Lets JobNgin::wait_for poll the queue without taking the lock
+        }
+        Entry entry;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (jobs_.empty()) {
+                return false;
+            }
+            entry = std::move(jobs_.front());
+            jobs_.pop_front();
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        if (!entry.handle.is_cancelled()) {
+            entry.task();
+        }
+        entry.task = nullptr; // Release captures before waiters see the job finish
+        entry.handle.complete();
+        return true;
+    }
+
+    // Jobs waiting for the main thread.
+    size_t size() const {
+        return queued_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Entry {
+        std::function<void()> task;
+        JobHandle handle;
+    };
+
+    std::atomic<std::thread::id> main_thread_;
+    std::mutex mutex_;
+    std::deque<Entry> jobs_;
+    std::atomic<size_t> queued_{0}; // jobs_.size(), readable without the lock
+};
+
+}
+}
+
+#endif // JOB_MAIN_THREAD_H
@@ -2,6 +2,7 @@
 #define JOB_NGIN_H
 
 #include <vector>
+#include <array>
 #include <deque>
 #include <functional>
 #include <thread>
@@ -17,37 +18,60 @@
 #include <utility>
 #include <numeric> // For std::iota
 #include <algorithm> // For std::remove
+#include <optional>
+#include <type_traits>
 
 #include <ngin/debug/logger.h>
 #include <ngin/job/job.h>
 #include <ngin/job/handle.h>
 #include <ngin/job/thread.h> 
-
-// Static helper function to convert JobType enum to a string for logging
-static inline std::string to_string(JobType type) {
-    switch (type) {
-        case JobType::AssetSetup: return "AssetSetup";
-        case JobType::Physics: return "Physics";
-        case JobType::Animation: return "Animation";
-        case JobType::AI: return "AI";
-        case JobType::TransformSync: return "TransformSync";
-        case JobType::RenderCommandGeneration: return "RenderCommandGeneration";
-        case JobType::AssetLoading: return "AssetLoading";
-        case JobType::Other: return "Other";
-        case JobType::None: return "None";
-        default: return "Unknown";
-    }
-}
+#include <ngin/job/pool.h>
+#include <ngin/job/arena.h>
+#include <ngin/job/fiber.h>
+#include <ngin/job/main_thread.h>
+#include <ngin/job/parking.h>
+#include <ngin/job/trace.h>
+#include <ngin/job/topology.h>
+#include <ngin/job/collections/deque.h>
+#include <ngin/job/collections/inbox.h>
 
 namespace ngin {
 namespace jobs {
 
+// Construction-time settings for JobNgin.
+struct JobNginOptions {
+    // Run workers on fibers, so a job that calls wait_for parks and frees its worker for other
+    // jobs instead of running them on top of its own stack. Linux only; ignored elsewhere.
+    bool fibers = false;
+    size_t fiber_stack_size = 256 * 1024; // Stack size of each worker fiber
+    size_t trace_events_per_thread = 1 << 16; // Ring size of each thread's trace buffer, allocated on first capture
+    // Pin each worker to its own CPU, filling physical cores before SMT siblings. Linux only.
+    // Off by default: on a shared or cgroup-limited machine, hard pinning can tie workers to CPUs
+    // the process is competing for, where the scheduler would otherwise move them.
+    bool pin_workers = false;
+    // Most jobs a worker takes from one victim in a single steal: up to half of the victim's
+    // queue, capped here and at ParallelDeque::MAX_STEAL_BATCH. 1 restores one-job-per-steal.
+    size_t max_steal_batch = 32;
+    size_t frame_arena_size = 256 * 1024; // Initial size of each thread's frame arena; grows to fit a frame
+    // Elastic mode: only workers [0, N) take work, with N between min_workers and max_workers,
+    // and the rest retire to sleep, so a light load neither wakes nor contends with threads it
+    // does not need, nor takes CPU from other processes. N grows while workers are saturated and
+    // work is queued, and shrinks while they mostly sit idle and fail to find work to steal.
+    // Workers dedicated to a job type always stay active.
+    bool elastic = false;
+    unsigned int min_workers = 1;
+    unsigned int max_workers = 0;          // 0: every worker
+    size_t elastic_interval_us = 4000;     // How often the load is measured and N adjusted
+};
+
 class JobNgin {
 public:
     // A struct to hold a consistent snapshot of job counts for diagnostics.
     struct Snapshot {
         int total_pending = 0;
         std::map<JobType, int> type_counts;
+        uint64_t total_skipped = 0; // Jobs dropped unrun since construction, cancelled or past their deadline
+        size_t main_thread_pending = 0; // Jobs waiting in main_thread_queue()
     };
     // A struct to hold a snapshot of a single thread's queue for diagnostics.
     struct ThreadDiagnostics {
@@ -55,42 +79,86 @@ public:
         size_t job_count;
         std::map<JobType, int> type_counts;
         std::string dedication_type = "General"; // Default to general
+        int cpu = -1; // The CPU this worker is pinned to, -1 if unpinned
+        uint64_t jobs_executed = 0;  // Jobs this worker has run since construction
+        uint64_t steal_attempts = 0; // Victim queues it has probed for work
+        uint64_t jobs_stolen = 0;    // Jobs it has taken from other workers, including those stolen in bulk
+        uint64_t jobs_restolen = 0;  // Of those, jobs another worker had already stolen once
+        bool active = true;          // False while retired by elastic mode
     };
 
     /**
      * @brief Constructs the JobNgin.
      * @param num_threads The number of worker threads to create. Defaults to the hardware concurrency.
+     * @param options Construction-time settings, such as fiber mode.
      */
-    JobNgin(unsigned int num_threads = std::thread::hardware_concurrency())
+    JobNgin(unsigned int num_threads = std::thread::hardware_concurrency(), JobNginOptions options = JobNginOptions())
         : logger_(new ngin::debug::Logger("JobNgin")),
+          options_(options),
           num_threads_(num_threads),
-          total_pending_jobs_count_(0),
           submit_thread_index_(0),
-          per_queue_mutexes_(num_threads)
+          parking_(std::max(num_threads, 1u)),
+          instance_id_(next_instance_id_.fetch_add(1, std::memory_order_relaxed)),
+          tracer_(options.trace_events_per_thread)
     {
         if (num_threads_ == 0) {
             num_threads_ = 1; 
         }
         logger_->info("JobNgin setup with " + std::to_string(num_threads_) + " threads");
+#if !NGIN_JOB_FIBERS
+        if (options_.fibers) {
+            logger_->warn("Fiber mode is not supported on this platform; workers will block in wait_for.");
+            options_.fibers = false;
+        }
+#endif
 
         for (int i = static_cast<int>(JobType::None); i <= static_cast<int>(JobType::Other); ++i) {
-            job_type_counts_[static_cast<JobType>(i)].store(0);
+            type_priorities_[i].store(default_job_priority(static_cast<JobType>(i)), std::memory_order_relaxed);
         }
         
-        per_thread_queues_.resize(num_threads_);
+        options_.max_steal_batch = std::clamp<size_t>(options_.max_steal_batch, 1, ParallelDeque<Job>::MAX_STEAL_BATCH);
+        if (options_.max_workers == 0 || options_.max_workers > num_threads_) {
+            options_.max_workers = num_threads_;
+        }
+        options_.min_workers = std::clamp(options_.min_workers, 1u, options_.max_workers);
+        active_workers_.store(options_.elastic ? options_.max_workers : num_threads_, std::memory_order_relaxed);
+        per_thread_queues_.reserve(num_threads_);
+        for (unsigned int i = 0; i < num_threads_; ++i) {
+            per_thread_queues_.emplace_back(std::make_unique<WorkerQueue>());
+            per_thread_queues_.back()->steal_rng = 0x9E3779B97F4A7C15ull * (i + 1);
+            for (PriorityLane& lane : per_thread_queues_.back()->lanes) {
+                lane.deque.set_max_steal_batch(options_.max_steal_batch);
+            }
+        }
         
         // Initially, all threads are general-purpose
-        general_purpose_thread_indices_.resize(num_threads_);
-        std::iota(general_purpose_thread_indices_.begin(), general_purpose_thread_indices_.end(), 0);
+        auto routing = std::make_unique<RoutingTable>();
+        routing->dedicated.fill(-1);
+        routing->num_workers = num_threads_;
+        routing->general.resize(num_threads_);
+        std::iota(routing->general.begin(), routing->general.end(), 0);
+        routing_.store(routing.get(), std::memory_order_release);
+        routing_tables_.push_back(std::move(routing));
+
+        plan_worker_placement_();
 
+        bool unpinned = false;
         for (unsigned int i = 0; i < num_threads_; ++i) {
             worker_threads_.emplace_back(std::make_unique<ngin::jobs::Thread>(
                 i,
-                [this](unsigned int thread_id, std::atomic<bool>& stop_flag, std::mutex& mtx, std::condition_variable& cv) {
-                    this->worker_thread_loop(thread_id, stop_flag, mtx, cv);
+                [this](unsigned int thread_id, std::atomic<bool>& stop_flag) {
+                    this->worker_thread_loop(thread_id, stop_flag);
                 },
                 logger_
             ));
+            if (worker_cpus_[i] != -1 && !pin_thread_to_cpu(worker_threads_[i]->native_handle(), worker_cpus_[i])) {
+                logger_->warn("Could not pin worker " + std::to_string(i) + " to CPU " + std::to_string(worker_cpus_[i]));
+                worker_cpus_[i] = -1;
+                unpinned = true;
+            }
+        }
+        if (unpinned) {
+            publish_steal_orders_();
         }
     }
 
@@ -99,103 +167,196 @@ public:
      */
     ~JobNgin() {
         shutdown();
+        // Queued jobs live in the pools; freeing the pools destroys them.
+        thread_pools_.clear();
         delete logger_;
     }
 
 
-    void dedicate_thread_to_job_type(JobType type, unsigned int thread_index) {
+    /**
+     * @brief Routes every job of `type` to one worker, optionally pinning that worker to a CPU.
+     * @param type The job type to dedicate.
+     * @param thread_index The worker that receives the jobs.
+     * @param cpu Logical CPU to pin the worker to, or -1 to leave its affinity as it is.
+     */
+    void dedicate_thread_to_job_type(JobType type, unsigned int thread_index, int cpu = -1) {
         if (thread_index >= num_threads_) {
             logger_->warn("Attempted to dedicate an invalid thread index: " + std::to_string(thread_index));
             return;
         }
         
         std::lock_guard<std::mutex> lock(dedication_mutex_);
+
+        if (cpu != -1) {
+            if (thread_index < worker_threads_.size() && pin_thread_to_cpu(worker_threads_[thread_index]->native_handle(), cpu)) {
+                worker_cpus_[thread_index] = cpu;
+                publish_steal_orders_(); // Its neighbours, and it as theirs, have changed
+                logger_->info("Thread " + std::to_string(thread_index) + " pinned to CPU " + std::to_string(cpu) + ".");
+            } else {
+                logger_->warn("Could not pin thread " + std::to_string(thread_index) + " to CPU " + std::to_string(cpu));
+            }
+        }
         
-        // Store the dedication
-        thread_dedications_[type] = thread_index;
-        
-        // Remove this thread from the pool of general purpose threads if it's there
-        auto& indices = general_purpose_thread_indices_;
+        // Publish a new routing table: this type goes to the thread, which leaves the general pool.
+        // Submitters may still be reading the old table, so it is kept until destruction.
+        auto routing = std::make_unique<RoutingTable>(*routing_.load(std::memory_order_relaxed));
+        routing->dedicated[static_cast<size_t>(type)] = static_cast<int>(thread_index);
+        auto& indices = routing->general;
         indices.erase(std::remove(indices.begin(), indices.end(), thread_index), indices.end());
+        routing_.store(routing.get(), std::memory_order_release);
+        routing_tables_.push_back(std::move(routing));
         
         logger_->info("Thread " + std::to_string(thread_index) + " dedicated to " + to_string(type) + " jobs.");
     }
 
+    /**
+     * @brief Sets the priority that jobs of `type` are scheduled at from now on.
+     * Jobs already queued keep the priority they were submitted with.
+     */
+    void set_job_type_priority(JobType type, JobPriority priority) {
+        type_priorities_[static_cast<size_t>(type)].store(priority, std::memory_order_relaxed);
+    }
+
+    JobPriority get_job_type_priority(JobType type) const {
+        return type_priorities_[static_cast<size_t>(type)].load(std::memory_order_relaxed);
+    }
+
     /**
      * @brief Submits a single job to the system.
-     * The job is assigned to a worker queue in a round-robin fashion.
-     * @param task_func The function to execute.
+     * The job is queued on the worker dedicated to its type, if any, and otherwise on the
+     * general-purpose workers round-robin, in the lane of its type's priority (see
+     * set_job_type_priority). Routing takes no lock.
+     * The job is dropped unrun, though still counted as finished, if `handle` is cancelled or
+     * `deadline` has passed by the time a worker dequeues it.
+     * @param task_func The callable to execute. Stored inline in the job when it fits.
      * @param type The type of the job.
-     * @param handle The handle this job will contribute to.
+     * @param handle The handle this job will contribute to. If it is empty or already complete it
+     *               is re-pointed at a fresh counter, which copies taken earlier do not follow; copy
+     *               the handle after this call.
+     * @param deadline Latest time the job may start; by default it always runs.
      */
-    void submit(std::function<void()> task_func, JobType type, JobHandle& handle) {
-        handle.get_counter()->fetch_add(1, std::memory_order_release);
-        Job new_job(std::move(task_func), type, handle);
+    template<typename Fn>
+    void submit(Fn&& task_func, JobType type, JobHandle& handle, std::chrono::steady_clock::time_point deadline = NO_JOB_DEADLINE) {
+        handle.add_pending(1);
+        Job* new_job = acquire_job_(std::forward<Fn>(task_func), type, handle, deadline);
+        StatShard::add(local_stats_().submitted, type, 1);
 
-        job_type_counts_[type].fetch_add(1, std::memory_order_release);
-        total_pending_jobs_count_.fetch_add(1, std::memory_order_release);
-        
-        unsigned int queue_index;
-        
-        // Check for a dedicated thread first
-        std::lock_guard<std::mutex> lock(dedication_mutex_);
-        auto it = thread_dedications_.find(type);
-        if (it != thread_dedications_.end()) {
-            queue_index = it->second;
-        } else {
-            // Otherwise, assign to a general-purpose thread round-robin
-            if (general_purpose_thread_indices_.empty()) {
-                // Fallback if all threads are dedicated, just use regular round-robin on all threads
-                 queue_index = submit_thread_index_.fetch_add(1) % num_threads_;
-            } else {
-                unsigned int general_purpose_pool_index = submit_thread_index_.fetch_add(1) % general_purpose_thread_indices_.size();
-                queue_index = general_purpose_thread_indices_[general_purpose_pool_index];
-            }
-        }
-        
-        push_to_queue(queue_index, std::move(new_job));
+        const RoutingTable& routing = *routing_.load(std::memory_order_acquire);
+        int dedicated = routing.dedicated[static_cast<size_t>(type)];
+        unsigned int queue_index = dedicated >= 0
+            ? static_cast<unsigned int>(dedicated)
+            : routing.general_worker(submit_thread_index_.fetch_add(1, std::memory_order_relaxed), routing.general_count(active_workers_.load(std::memory_order_relaxed)));
+
+        push_to_queue(queue_index, new_job);
 
-        worker_cv_.notify_one();
+        wake_workers_(1);
     }
 
     /**
      * @brief Submits a batch of jobs that all contribute to a single new handle.
+     * Never blocks: jobs with unfinished dependencies are registered now and released to the
+     * worker queues by whichever thread completes the last dependency.
      * @param task_funcs A vector of functions to execute.
      * @param type The type of all jobs in this batch.
      * @param dependencies A vector of handles that must complete before these jobs can start.
-     * @return A new JobHandle that represents this batch of work.
+     * @return A new JobHandle that represents this batch of work. An empty batch with
+     *         dependencies yields a handle that completes when they all have.
      */
     JobHandle submit_jobs(const std::vector<std::function<void()>>& task_funcs, JobType type, const std::vector<JobHandle>& dependencies = {}) {
-        JobHandle new_handle;
-        for (const auto& dep_handle : dependencies) {
-            wait_for(dep_handle);
+        return submit_batch_(task_funcs, type, dependencies);
+    }
+
+    /**
+     * @brief Bulk overload of submit_jobs that moves each task into its job instead of copying it.
+     * `Fn` may be std::function or any other callable type, so a vector of lambdas is queued
+     * without wrapping each one in a std::function first.
+     */
+    template<typename Fn>
+    JobHandle submit_jobs(std::vector<Fn>&& task_funcs, JobType type, const std::vector<JobHandle>& dependencies = {}) {
+        return submit_batch_(std::move(task_funcs), type, dependencies);
+    }
+
+    /**
+     * @brief Queues `count` jobs, job i running `task(i)`, as one batch counted against `handle`.
+     * Every job holds its own copy of `task`, so keep it small enough to be stored inline (a
+     * pointer and an index, say); a batch then allocates nothing once the job pool is warm.
+     */
+    template<typename Fn>
+    void submit_each(size_t count, const Fn& task, JobType type, JobHandle& handle) {
+        if (count == 0) {
+            return;
+        }
+        handle.add_pending(static_cast<int>(count));
+        JobBatch jobs;
+        for (size_t i = 0; i < count; ++i) {
+            jobs.append(acquire_job_([task, i]() {
+                task(i);
+            }, type, handle));
         }
+        enqueue_jobs_(jobs, type);
+    }
 
-        size_t num_jobs = task_funcs.size();
-        new_handle.get_counter()->fetch_add(num_jobs, std::memory_order_release);
-        job_type_counts_[type].fetch_add(num_jobs, std::memory_order_release);
-        total_pending_jobs_count_.fetch_add(num_jobs, std::memory_order_release);
-        
-        for (const auto& task_func : task_funcs) {
-            Job new_job(task_func, type, new_handle);
-            unsigned int queue_index = submit_thread_index_.fetch_add(1) % num_threads_;
-            push_to_queue(queue_index, std::move(new_job));
+    /**
+     * @brief Runs `fn` over the index range [begin, end) without creating a job per element.
+     *
+     * The range starts as a single job. A job running a range hands the upper half of it to its own
+     * deque only while that deque is empty, i.e. when there is nothing else for idle workers to steal;
+     * otherwise it works through the range `grain` elements at a time (lazy binary splitting). The
+     * number of jobs therefore tracks how much stealing actually happens rather than the range size.
+     *
+     * @param begin First index.
+     * @param end One past the last index.
+     * @param grain Smallest chunk handed to `fn` in one go. Pass 0 to derive it from the range size
+     *              and worker count.
+     * @param fn Either `void(size_t index)` or `void(size_t chunk_begin, size_t chunk_end)`. Called
+     *           concurrently from several workers.
+     * @param type The type the range's jobs are accounted under.
+     * @param dependencies Handles that must complete before the range starts.
+     * @return A handle that completes once every index has been processed.
+     */
+    template<typename Fn>
+    JobHandle parallel_for(size_t begin, size_t end, size_t grain, Fn fn, JobType type = JobType::Other, const std::vector<JobHandle>& dependencies = {}) {
+        if (begin >= end) {
+            return submit_jobs({}, type, dependencies);
+        }
+        if (grain == 0) {
+            grain = std::max<size_t>(1, (end - begin) / (static_cast<size_t>(num_threads_) * 8));
         }
 
-        worker_cv_.notify_all();
-        return new_handle;
+        JobHandle handle;
+        handle.add_pending(1);
+        auto range = std::make_shared<ParallelForRange<Fn>>(std::move(fn), grain, type, get_job_type_priority(type), handle);
+        JobBatch root;
+        root.append(acquire_job_(make_range_task_(range, begin, end), type, handle));
+        enqueue_after_(root, type, dependencies, handle);
+        return handle;
     }
 
     /**
      * @brief Stalls the calling thread until the specified handle is complete.
      * While waiting, this thread will participate in executing other jobs from the system.
+     * In fiber mode, a job waiting on a worker instead parks its fiber and is resumed, possibly
+     * on another worker, once the handle completes; the worker carries on with other jobs.
+     * On the main thread, jobs queued for it through main_thread_queue() run here too.
      * @param handle The handle to wait for.
      */
     void wait_for(const JobHandle& handle) {
+#if NGIN_JOB_FIBERS
+        if (!handle.is_complete() && current_fiber_thread_()) {
+            park_current_fiber_(handle);
+            return;
+        }
+#endif
+        // The main thread runs its own queue first: the handle may be waiting on a job only it can run.
+        bool main_thread = main_thread_queue_.is_main_thread();
         // While the handle we are waiting for is not complete...
         while (!handle.is_complete()) {
+            if (main_thread && main_thread_queue_.run_one()) {
+                continue;
+            }
             // ...try to execute another job from anywhere in the system.
-            if (!try_execute_a_job(-1)) { // -1 indicates this is not a worker thread
+            // A worker waiting inside a job keeps draining its own queue first; any other thread passes -1.
+            if (!try_execute_a_job(current_worker_index_())) {
                 // If there was no work to steal, yield the thread to prevent a busy-wait spin.
                 std::this_thread::yield();
             }
@@ -203,17 +364,63 @@ public:
     }
 
     /**
-     * @brief Gets a consistent snapshot of the current job counts for diagnostics.
+     * @brief Gets a snapshot of the pending job counts for diagnostics.
+     * Sums every thread's statistics shard, so it costs a lock and a pass over all shards but
+     * never slows down submission or execution. The counts are approximate: shards are read one
+     * at a time while jobs keep moving.
      * @return A Snapshot struct containing job counts.
      */
     Snapshot get_diagnostics_snapshot() const {
+        std::array<int64_t, JOB_TYPE_COUNT> pending{};
+        std::array<uint64_t, JOB_TYPE_COUNT> skipped{};
+        {
+            std::lock_guard<std::mutex> lock(pools_mutex_);
+            for (const auto& pair : thread_stats_) {
+                for (size_t i = 0; i < JOB_TYPE_COUNT; ++i) {
+                    pending[i] += static_cast<int64_t>(pair.second->submitted[i].load(std::memory_order_relaxed));
+                    pending[i] -= static_cast<int64_t>(pair.second->completed[i].load(std::memory_order_relaxed));
+                    skipped[i] += pair.second->skipped[i].load(std::memory_order_relaxed);
+                }
+            }
+        }
         Snapshot snapshot;
-        snapshot.total_pending = total_pending_jobs_count_.load(std::memory_order_relaxed);
-        for (const auto& pair : job_type_counts_) {
-            snapshot.type_counts[pair.first] = pair.second.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < JOB_TYPE_COUNT; ++i) {
+            // A completion can be read before the submission it balances.
+            int count = static_cast<int>(std::max<int64_t>(pending[i], 0));
+            snapshot.total_skipped += skipped[i];
+            snapshot.type_counts[static_cast<JobType>(i)] = count;
+            snapshot.total_pending += count;
         }
+        snapshot.main_thread_pending = main_thread_queue_.size();
         return snapshot;
     }
+
+    /**
+     * @brief True if every worker is asleep and no queue holds a job.
+     * Looks only at the parking lot and the queue heads, not the job counters, so it is cheap
+     * enough to poll. Like any such check it can miss work submitted concurrently, and a job
+     * being run by a thread helping out in wait_for.
+     */
+    bool is_idle() const {
+        return parking_.parked() == num_threads_ && !has_queued_work_();
+    }
+    // Number of worker threads.
+    unsigned int num_threads() const {
+        return num_threads_;
+    }
+
+    /**
+     * @brief Workers currently taking work: all of them, unless elastic mode has retired some.
+     * Workers dedicated to a job type are counted even when elastic mode would retire their slot.
+     */
+    unsigned int active_workers() const {
+        unsigned int active = 0;
+        for (unsigned int i = 0; i < num_threads_; ++i) {
+            active += is_retired_(i) ? 0 : 1;
+        }
+        return active;
+    }
+
     std::vector<ThreadDiagnostics> get_thread_diagnostics() const {
         std::vector<ThreadDiagnostics> diagnostics;
         diagnostics.resize(num_threads_);
@@ -225,34 +432,118 @@ public:
             for (unsigned int i = 0; i < num_threads_; ++i) {
                 diagnostics[i].thread_id = i;
                 diagnostics[i].dedication_type = "General"; // Default status
+                diagnostics[i].cpu = worker_cpus_[i];
             }
             // Override with specific dedications
-            for (const auto& pair : thread_dedications_) {
-                JobType type = pair.first;
-                unsigned int thread_id = pair.second;
-                if (thread_id < num_threads_) {
-                    diagnostics[thread_id].dedication_type = to_string(type);
+            const RoutingTable& routing = *routing_.load(std::memory_order_acquire);
+            for (size_t type = 0; type < JOB_TYPE_COUNT; ++type) {
+                int thread_id = routing.dedicated[type];
+                if (thread_id >= 0) {
+                    diagnostics[thread_id].dedication_type = to_string(static_cast<JobType>(type));
                 }
             }
         }
 
-        // Now, iterate through each thread's queue to get job counts
+        // Now read each thread's queued-job counters. The queues are lock-free, so these
+        // counts are a relaxed view that may be momentarily stale while jobs are moving.
         for (unsigned int i = 0; i < num_threads_; ++i) {
-            // Lock the specific queue we are about to inspect
-            std::lock_guard<std::mutex> lock(per_queue_mutexes_[i]);
-            
-            const auto& queue = per_thread_queues_[i];
-            diagnostics[i].job_count = queue.size();
-            
-            // Count the types of jobs in this thread's queue
-            for (const auto& job : queue) {
-                diagnostics[i].type_counts[job.type]++;
+            const auto& queue = *per_thread_queues_[i];
+            diagnostics[i].job_count = 0;
+
+            for (size_t type = 0; type < JOB_TYPE_COUNT; ++type) {
+                int count = queue.type_counts[type].load(std::memory_order_relaxed);
+                if (count > 0) {
+                    diagnostics[i].type_counts[static_cast<JobType>(type)] = count;
+                    diagnostics[i].job_count += count;
+                }
             }
+            diagnostics[i].jobs_executed = queue.jobs_executed.load(std::memory_order_relaxed);
+            diagnostics[i].steal_attempts = queue.steal_attempts.load(std::memory_order_relaxed);
+            diagnostics[i].jobs_stolen = queue.jobs_stolen.load(std::memory_order_relaxed);
+            diagnostics[i].jobs_restolen = queue.jobs_restolen.load(std::memory_order_relaxed);
+            diagnostics[i].active = !is_retired_(i);
         }
 
         return diagnostics;
     }
 
+    /**
+     * @brief Records every job run during the next `frame_count` frames.
+     * The capture starts at the next mark_frame() and ends by itself; fetch it with write_trace.
+     * Until then, tracing costs one relaxed load per job.
+     */
+    void start_trace(size_t frame_count) {
+        tracer_.start(frame_count);
+    }
+
+    /**
+     * @brief Marks the start of a new frame. Call once per frame from the frame loop.
+     * Needed for start_trace, and ends the lifetime of everything allocated from frame arenas.
+     */
+    void mark_frame() {
+        frame_epoch_.fetch_add(1, std::memory_order_release);
+        tracer_.mark_frame();
+    }
+
+    /**
+     * @brief The calling thread's frame arena: scratch memory for jobs, reset every frame.
+     *
+     * Every worker, and any other thread that asks, owns one arena, so allocating is a pointer
+     * bump with no lock and, once the arena has grown to fit a frame, no malloc. Allocations
+     * stay valid until the next mark_frame(); the arena resets itself the first time it is
+     * used after that. Memory may be handed to other jobs and the main thread within the frame,
+     * but never kept across it.
+     *
+     * Fetch the arena where it is used rather than holding on to it: in fiber mode a job that
+     * calls wait_for may resume on another worker, whose arena it must then use.
+     */
+    FrameArena& frame_arena() {
+        local_pool_(); // Claims the thread's context for this JobNgin
+        WorkerContext& context = worker_context_();
+        uint64_t epoch = frame_epoch_.load(std::memory_order_acquire);
+        if (!context.arena) {
+            std::lock_guard<std::mutex> lock(pools_mutex_);
+            std::unique_ptr<FrameArena>& arena = thread_arenas_[std::this_thread::get_id()];
+            if (!arena) {
+                arena = std::make_unique<FrameArena>(options_.frame_arena_size);
+            }
+            context.arena = arena.get();
+            context.arena_epoch = epoch;
+        }
+        if (context.arena_epoch != epoch) {
+            context.arena->reset();
+            context.arena_epoch = epoch;
+        }
+        return *context.arena;
+    }
+
+    /**
+     * @brief Jobs that must run on the main thread, the one that constructed this JobNgin.
+     * Workers hand work that needs the GL context here; the main thread runs it from
+     * MainThreadQueue::run each frame and while it waits in wait_for.
+     */
+    MainThreadQueue& main_thread_queue() {
+        return main_thread_queue_;
+    }
+
+    // True from start_trace until the requested frames have been captured.
+    bool is_tracing() const {
+        return tracer_.pending();
+    }
+
+    /**
+     * @brief Writes the most recent capture as Chrome trace JSON, viewable in chrome://tracing or Perfetto.
+     * @return False if the file could not be written.
+     */
+    bool write_trace(const std::string& path) const {
+        if (!tracer_.write_chrome_trace(path)) {
+            logger_->warn("Could not write job trace to " + path);
+            return false;
+        }
+        logger_->info("Job trace written to " + path);
+        return true;
+    }
+
     /**
      * @brief Signals all worker threads to stop and joins them.
      * This ensures a clean shutdown.
@@ -263,7 +554,7 @@ public:
             for (const auto& worker_thread_ptr : worker_threads_) {
                 worker_thread_ptr->signal_stop();
             }
-            worker_cv_.notify_all();
+            parking_.unpark_all();
             for (std::unique_ptr<ngin::jobs::Thread>& worker : worker_threads_) {
                 if (worker->joinable()) {
                     worker->join();
@@ -277,136 +568,1108 @@ public:
 private:
     // --- START: Integrated Queue Logic and Helpers ---
 
-    void push_to_queue(unsigned int queue_index, Job item) {
-        std::lock_guard<std::mutex> lock(per_queue_mutexes_[queue_index]);
-        per_thread_queues_[queue_index].push_back(std::move(item));
+    // Each worker owns a Chase-Lev deque for jobs it pushes itself, plus an inbox that
+    // every other thread pushes into, per JobPriority. Neither takes a lock.
+    struct PriorityLane {
+        ParallelDeque<Job> deque;  // Owner push/pop at the bottom, thieves steal from the top
+        ParallelInbox<Job> inbox;  // Submissions from non-owner threads
+    };
+    struct WorkerQueue {
+        std::array<PriorityLane, JOB_PRIORITY_COUNT> lanes; // Indexed by JobPriority
+        std::array<std::atomic<int>, JOB_TYPE_COUNT> type_counts{}; // Queued jobs by type, for diagnostics
+        // Written by the owning worker only; other threads just read the counters.
+        alignas(64) uint64_t steal_rng = 0; // xorshift state picking where each victim scan starts
+        std::atomic<uint64_t> jobs_executed{0};
+        std::atomic<uint64_t> steal_attempts{0};
+        std::atomic<uint64_t> jobs_stolen{0};
+        std::atomic<uint64_t> jobs_restolen{0};
+        std::atomic<uint64_t> failed_scans{0};  // Looks for work that found none anywhere
+        // Elastic mode only: time spent looking for work or asleep, and when the current idle spell began (0: busy).
+        std::atomic<uint64_t> idle_ns{0};
+        std::atomic<uint64_t> idle_since_ns{0};
+    };
+
+    // Jobs submitted and completed on one thread, by type. Only the owning thread writes its
+    // shard, so a count is bumped with a plain load and store rather than a locked add, and no
+    // two threads share its cache lines. get_diagnostics_snapshot sums all shards.
+    struct alignas(64) StatShard {
+        std::array<std::atomic<uint64_t>, JOB_TYPE_COUNT> submitted{};
+        std::array<std::atomic<uint64_t>, JOB_TYPE_COUNT> completed{}; // Including skipped jobs
+        std::array<std::atomic<uint64_t>, JOB_TYPE_COUNT> skipped{};
+
+        static void add(std::array<std::atomic<uint64_t>, JOB_TYPE_COUNT>& counts, JobType type, uint64_t count) {
+            std::atomic<uint64_t>& counter = counts[static_cast<size_t>(type)];
+            counter.store(counter.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+        }
+    };
+
+    // The workers a thief may steal from, nearest first, grouped into tiers of equal distance.
+    struct StealOrder {
+        std::vector<unsigned int> victims;
+        std::vector<size_t> tier_ends; // One past the last victim of each tier
+    };
+
+    // Identifies the JobNgin worker, if any, running on the current thread, and that
+    // thread's job pool. Keyed by instance id rather than address, so a JobNgin
+    // created where an old one lived never sees stale state.
+    struct WorkerContext {
+        uint64_t instance;
+        int index;
+        JobPool* pool;
+        std::atomic<bool>* stop_flag; // Workers only
+        void* fiber_thread;           // The worker's FiberThread in fiber mode, else nullptr
+        JobTraceBuffer* trace;        // Created on the first job traced on this thread
+        FrameArena* arena;            // Created on the first frame_arena() call on this thread
+        StatShard* stats;             // This thread's job statistics
+        uint64_t arena_epoch;         // frame_epoch_ when the arena was last reset
+    };
+    static inline thread_local WorkerContext tls_worker_{0, -1, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, 0};
+    static inline std::atomic<uint64_t> next_instance_id_{1};
+
+    /**
+     * @brief The calling thread's WorkerContext.
+     * In fiber mode a job can resume on a different thread than it started on, so the compiler
+     * must not keep a thread-local address cached across a call that might switch fibers. Every
+     * access goes through this opaque call instead.
+     */
+    [[gnu::noinline]] static WorkerContext& worker_context_() {
+        asm volatile("");
+        return tls_worker_;
     }
 
-    bool try_pop_from_queue(unsigned int queue_index, Job& item) {
-        std::lock_guard<std::mutex> lock(per_queue_mutexes_[queue_index]);
-        auto& queue = per_thread_queues_[queue_index];
-        if (queue.empty()) {
-            return false;
+    int current_worker_index_() const {
+        const WorkerContext& context = worker_context_();
+        return context.instance == instance_id_ ? context.index : -1;
+    }
+
+    // The calling thread's job pool, created on first use from a non-worker thread.
+    JobPool& local_pool_() {
+        WorkerContext& context = worker_context_();
+        if (context.instance == instance_id_) {
+            return *context.pool;
         }
-        item = std::move(queue.back());
-        queue.pop_back();
-        return true;
+        std::lock_guard<std::mutex> lock(pools_mutex_);
+        std::unique_ptr<JobPool>& pool = thread_pools_[std::this_thread::get_id()];
+        if (!pool) {
+            pool = std::make_unique<JobPool>();
+        }
+        context = WorkerContext{instance_id_, -1, pool.get(), nullptr, nullptr, nullptr, nullptr, local_stats_locked_(), 0};
+        return *pool;
     }
 
-    bool try_steal_from_queue(unsigned int queue_index, Job& item) {
-        std::lock_guard<std::mutex> lock(per_queue_mutexes_[queue_index]);
-        auto& queue = per_thread_queues_[queue_index];
-        if (queue.empty()) {
-            return false;
+    // The calling thread's statistics shard. In fiber mode, always look it up afresh after a job
+    // has run, since the job may have finished on another thread.
+    StatShard& local_stats_() {
+        WorkerContext& context = worker_context_();
+        if (context.instance != instance_id_) {
+            local_pool_(); // Claims the context for this JobNgin
         }
-        item = std::move(queue.front());
-        queue.pop_front();
-        return true;
+        return *context.stats;
     }
-    
-    void pop_all_from_queue(unsigned int queue_index, std::vector<Job>& items) {
-        std::lock_guard<std::mutex> lock(per_queue_mutexes_[queue_index]);
-        auto& queue = per_thread_queues_[queue_index];
-        if (queue.empty()) {
+
+    // Finds or creates the calling thread's shard. Requires pools_mutex_.
+    StatShard* local_stats_locked_() {
+        std::unique_ptr<StatShard>& stats = thread_stats_[std::this_thread::get_id()];
+        if (!stats) {
+            stats = std::make_unique<StatShard>();
+        }
+        return stats.get();
+    }
+
+    template<typename Fn>
+    Job* acquire_job_(Fn&& task_func, JobType type, const JobHandle& handle, std::chrono::steady_clock::time_point deadline = NO_JOB_DEADLINE) {
+        Job* job = local_pool_().acquire();
+        job->task.assign(std::forward<Fn>(task_func));
+        job->type = type;
+        job->priority = get_job_type_priority(type);
+        job->handle = handle;
+        job->deadline = deadline;
+        job->stolen = false;
+        return job;
+    }
+
+    void release_job_(Job* job) {
+        const WorkerContext& context = worker_context_();
+        bool owner_thread = context.instance == instance_id_ && context.pool == job->pool;
+        job->pool->release(job, owner_thread);
+    }
+
+    // A chain of jobs linked through Job::next, in submission order.
+    struct JobBatch {
+        Job* first = nullptr;
+        Job* last = nullptr;
+        size_t count = 0;
+
+        void append(Job* job) {
+            job->next = nullptr;
+            if (last) {
+                last->next = job;
+            } else {
+                first = job;
+            }
+            last = job;
+            ++count;
+        }
+    };
+
+    // Queues a job in the lane of its priority on worker `queue_index`.
+    void push_to_queue(unsigned int queue_index, Job* item) {
+        WorkerQueue& queue = *per_thread_queues_[queue_index];
+        PriorityLane& lane = queue.lanes[static_cast<size_t>(item->priority)];
+        queue.type_counts[static_cast<size_t>(item->type)].fetch_add(1, std::memory_order_relaxed);
+        if (current_worker_index_() == static_cast<int>(queue_index)) {
+            lane.deque.push(item);
+        } else {
+            lane.inbox.push(item);
+        }
+    }
+
+    // Owner-side pop: newest job from one lane of our own deque, falling back to that lane's inbox.
+    Job* try_pop_from_queue(unsigned int queue_index, size_t lane_index) {
+        WorkerQueue& queue = *per_thread_queues_[queue_index];
+        Job* item = queue.lanes[lane_index].deque.pop();
+        if (item) {
+            queue.type_counts[static_cast<size_t>(item->type)].fetch_sub(1, std::memory_order_relaxed);
+            return item;
+        }
+        return take_from_inbox(queue_index, queue_index, lane_index);
+    }
+
+    /**
+     * @brief Thief-side steal: oldest job from one lane of the victim's deque, falling back to that
+     * lane's inbox. Only workers take from inboxes, since they need a deque of their own to hold
+     * the rest of the batch; non-worker threads (-1) help through the deques alone.
+     *
+     * From a deque, a worker claims up to half of what it finds (at most max_steal_batch jobs)
+     * with one CAS, running the oldest and keeping the rest on its own deque, so a worker handed
+     * a large batch is relieved in a few steals rather than one job per steal. An inbox is always
+     * taken whole; its jobs then sit on the thief's deque, where others can steal half of them.
+     */
+    Job* try_steal_from_queue(unsigned int queue_index, int thief_index, size_t lane_index) {
+        WorkerQueue& queue = *per_thread_queues_[queue_index];
+        Job* batch[ParallelDeque<Job>::MAX_STEAL_BATCH];
+        size_t taken = queue.lanes[lane_index].deque.steal_batch(batch, thief_index == -1 ? 1 : options_.max_steal_batch);
+        if (taken > 0) {
+            queue.type_counts[static_cast<size_t>(batch[0]->type)].fetch_sub(1, std::memory_order_relaxed);
+            if (thief_index != -1) {
+                WorkerQueue& thief = *per_thread_queues_[thief_index];
+                count_steal_(thief, batch[0]);
+                for (size_t i = 1; i < taken; ++i) {
+                    size_t type = static_cast<size_t>(batch[i]->type);
+                    queue.type_counts[type].fetch_sub(1, std::memory_order_relaxed);
+                    thief.type_counts[type].fetch_add(1, std::memory_order_relaxed);
+                    count_steal_(thief, batch[i]); // Before the push makes it stealable again
+                    thief.lanes[lane_index].deque.push(batch[i]);
+                }
+            }
+            return batch[0];
+        }
+        if (thief_index == -1) {
+            return nullptr;
+        }
+        return take_from_inbox(queue_index, static_cast<unsigned int>(thief_index), lane_index);
+    }
+
+    // Counts `job` as stolen by `thief`, separately if an earlier thief had already moved it.
+    static void count_steal_(WorkerQueue& thief, Job* job) {
+        (job->stolen ? thief.jobs_restolen : thief.jobs_stolen).fetch_add(1, std::memory_order_relaxed);
+        job->stolen = true;
+    }
+
+    /**
+     * @brief Empties one lane of a worker's inbox into the same lane of the taker's own deque,
+     * returning the oldest job to run now.
+     * @param queue_index The worker whose inbox is emptied.
+     * @param taker_index The calling worker; the remaining jobs become poppable and stealable there.
+     * @param lane_index The JobPriority lane to take from.
+     */
+    Job* take_from_inbox(unsigned int queue_index, unsigned int taker_index, size_t lane_index) {
+        WorkerQueue& victim = *per_thread_queues_[queue_index];
+        Job* newest = victim.lanes[lane_index].inbox.take_all();
+        if (!newest) {
+            return nullptr;
+        }
+
+        // The inbox hands items back newest-first; reverse into submission order.
+        Job* oldest = nullptr;
+        while (newest) {
+            Job* next = newest->next;
+            newest->next = oldest;
+            oldest = newest;
+            newest = next;
+        }
+
+        WorkerQueue& taker = *per_thread_queues_[taker_index];
+        if (&taker != &victim) {
+            for (Job* job = oldest; job; job = job->next) {
+                count_steal_(taker, job);
+            }
+        }
+
+        Job* item = oldest;
+        Job* rest = item->next;
+        item->next = nullptr;
+        victim.type_counts[static_cast<size_t>(item->type)].fetch_sub(1, std::memory_order_relaxed);
+
+        while (rest) {
+            Job* next = rest->next;
+            rest->next = nullptr;
+            if (&taker != &victim) {
+                size_t type = static_cast<size_t>(rest->type);
+                victim.type_counts[type].fetch_sub(1, std::memory_order_relaxed);
+                taker.type_counts[type].fetch_add(1, std::memory_order_relaxed);
+            }
+            taker.lanes[lane_index].deque.push(rest);
+            rest = next;
+        }
+        return item;
+    }
+
+    /**
+     * @brief Wakes up to `count` parked workers after publishing that many new jobs.
+     * Costs no syscall while every worker is awake. Non-worker threads never drain inboxes,
+     * so the ParkingLot handshake is what guarantees a queued job is not stranded.
+     */
+    void wake_workers_(size_t count) {
+        parking_.unpark(std::min<size_t>(count, num_threads_));
+    }
+
+    // True if any queue holds a job, or a parked fiber is ready to resume. Read by a worker
+    // re-checking for work between ParkingLot::prepare_park and park.
+    bool has_queued_work_() const {
+        if (ready_fiber_count_.load(std::memory_order_relaxed) > 0) {
+            return true;
+        }
+        for (const auto& queue : per_thread_queues_) {
+            for (const PriorityLane& lane : queue->lanes) {
+                if (!lane.deque.empty() || !lane.inbox.empty()) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Shared body of the submit_jobs overloads; moves the tasks out of an rvalue `task_funcs`.
+    template<typename Tasks>
+    JobHandle submit_batch_(Tasks&& task_funcs, JobType type, const std::vector<JobHandle>& dependencies) {
+        // Arm the handle before the jobs copy it. An empty batch with dependencies is held
+        // open by a single placeholder count that the dependency gate releases.
+        JobHandle new_handle;
+        bool join_only = task_funcs.empty() && !dependencies.empty();
+        new_handle.add_pending(join_only ? 1 : static_cast<int>(task_funcs.size()));
+
+        JobBatch jobs;
+        for (auto& task_func : task_funcs) {
+            if constexpr (std::is_rvalue_reference_v<Tasks&&>) {
+                jobs.append(acquire_job_(std::move(task_func), type, new_handle));
+            } else {
+                jobs.append(acquire_job_(task_func, type, new_handle));
+            }
+        }
+
+        enqueue_after_(jobs, type, dependencies, new_handle);
+        return new_handle;
+    }
+
+    // Jobs held back until every dependency of their batch has completed.
+    struct DependencyGate {
+        std::atomic<int> remaining{0};
+        JobBatch jobs;
+        std::optional<JobHandle> join; // Set for empty batches, which only forward completion
+    };
+
+    /**
+     * @brief Queues a batch of jobs once all `dependencies` have completed, without blocking.
+     * The jobs must already be counted against `handle`. For an empty batch with dependencies,
+     * `handle` must carry one extra count, which is completed when the last one finishes.
+     */
+    void enqueue_after_(const JobBatch& jobs, JobType type, const std::vector<JobHandle>& dependencies, JobHandle handle) {
+        if (dependencies.empty()) {
+            enqueue_jobs_(jobs, type);
             return;
         }
-        items.reserve(items.size() + queue.size());
-        std::move(queue.begin(), queue.end(), std::back_inserter(items));
-        queue.clear();
+
+        // A join over the dependencies: the last one to complete releases the batch.
+        auto gate = std::make_shared<DependencyGate>();
+        gate->remaining.store(static_cast<int>(dependencies.size()), std::memory_order_relaxed);
+        gate->jobs = jobs;
+        if (gate->jobs.count == 0) {
+            gate->join = handle;
+        }
+
+        for (const auto& dep_handle : dependencies) {
+            JobHandle dependency = dep_handle;
+            dependency.on_complete([this, gate, type]() {
+                if (gate->remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                    return;
+                }
+                if (gate->join) {
+                    gate->join->complete();
+                } else {
+                    enqueue_jobs_(gate->jobs, type);
+                }
+            });
+        }
+    }
+
+    // Shared, read-mostly state for every job working on one parallel_for range.
+    template<typename Fn>
+    struct ParallelForRange {
+        Fn fn;
+        size_t grain;
+        JobType type;
+        size_t lane; // JobPriority of the range's jobs
+        JobHandle handle;
+
+        ParallelForRange(Fn f, size_t g, JobType t, JobPriority p, JobHandle h)
+            : fn(std::move(f)), grain(g), type(t), lane(static_cast<size_t>(p)), handle(std::move(h)) {}
+    };
+
+    template<typename Fn>
+    auto make_range_task_(const std::shared_ptr<ParallelForRange<Fn>>& range, size_t begin, size_t end) {
+        return [this, range, begin, end]() {
+            run_range_(range, begin, end);
+        };
+    }
+
+    template<typename Fn>
+    void run_range_(const std::shared_ptr<ParallelForRange<Fn>>& owner, size_t begin, size_t end) {
+        ParallelForRange<Fn>& range = *owner;
+        while (end - begin > range.grain) {
+            // Re-read every chunk: in fiber mode fn may wait and resume on another worker.
+            int worker = current_worker_index_();
+            if (worker == -1 || per_thread_queues_[worker]->lanes[range.lane].deque.empty()) {
+                // Nothing left for thieves here: offer them the upper half.
+                size_t mid = begin + (end - begin) / 2;
+                range.handle.add_pending(1);
+                Job* job = acquire_job_(make_range_task_(owner, mid, end), range.type, range.handle);
+                job->priority = static_cast<JobPriority>(range.lane);
+                spawn_(job);
+                end = mid;
+            } else {
+                size_t chunk_end = begin + range.grain;
+                invoke_range_(range.fn, begin, chunk_end);
+                begin = chunk_end;
+            }
+        }
+        invoke_range_(range.fn, begin, end);
+    }
+
+    template<typename Fn>
+    static void invoke_range_(Fn& fn, size_t begin, size_t end) {
+        if constexpr (std::is_invocable_v<Fn&, size_t, size_t>) {
+            fn(begin, end);
+        } else {
+            for (size_t i = begin; i < end; ++i) {
+                fn(i);
+            }
+        }
+    }
+
+    // Queues a single, already-counted job spawned from inside another job: onto the calling
+    // worker's own deque where possible, round-robin otherwise.
+    void spawn_(Job* job) {
+        StatShard::add(local_stats_().submitted, job->type, 1);
+
+        int worker = current_worker_index_();
+        unsigned int queue_index = worker != -1 ? static_cast<unsigned int>(worker) : submit_thread_index_.fetch_add(1) % active_workers_.load(std::memory_order_relaxed);
+        push_to_queue(queue_index, job);
+
+        wake_workers_(1);
+    }
+
+    /**
+     * @brief Publishes a batch of already-counted jobs of one type.
+     * A type with a dedicated worker goes to that worker whole. Otherwise the batch is cut
+     * into one contiguous chunk per active general-purpose worker, starting at the next round-robin
+     * slot. Each chunk is published with a single push: one CAS onto another worker's inbox,
+     * or plain deque pushes onto our own. One round-robin ticket covers the whole batch.
+     */
+    void enqueue_jobs_(const JobBatch& jobs, JobType type) {
+        if (jobs.count == 0) {
+            return;
+        }
+        StatShard::add(local_stats_().submitted, type, jobs.count);
+
+        const RoutingTable& routing = *routing_.load(std::memory_order_acquire);
+        int dedicated = routing.dedicated[static_cast<size_t>(type)];
+        size_t general = routing.general_count(active_workers_.load(std::memory_order_relaxed));
+        size_t targets = dedicated >= 0 ? 1 : general;
+        size_t chunks = std::min<size_t>(jobs.count, targets);
+        unsigned int first_queue = submit_thread_index_.fetch_add(static_cast<unsigned int>(chunks), std::memory_order_relaxed);
+
+        Job* job = jobs.first;
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            size_t size = jobs.count / chunks + (chunk < jobs.count % chunks ? 1 : 0);
+
+            // Relink the chunk newest-first, the order the inbox hands items back in.
+            Job* newest = nullptr;
+            Job* oldest = job;
+            for (size_t i = 0; i < size; ++i) {
+                Job* next = job->next;
+                job->next = newest;
+                newest = job;
+                job = next;
+            }
+            unsigned int queue_index = dedicated >= 0
+                ? static_cast<unsigned int>(dedicated)
+                : routing.general_worker(first_queue + static_cast<unsigned int>(chunk), general);
+            push_chunk_to_queue_(queue_index, newest, oldest, size, type);
+        }
+
+        // Other workers can steal from a dedicated worker, so wake as many as could help.
+        wake_workers_(dedicated >= 0 ? jobs.count : chunks);
+    }
+
+    // Queues a chain of `count` jobs of one type and priority, linked newest-first, on one worker.
+    void push_chunk_to_queue_(unsigned int queue_index, Job* newest, Job* oldest, size_t count, JobType type) {
+        WorkerQueue& queue = *per_thread_queues_[queue_index];
+        PriorityLane& lane = queue.lanes[static_cast<size_t>(newest->priority)];
+        queue.type_counts[static_cast<size_t>(type)].fetch_add(static_cast<int>(count), std::memory_order_relaxed);
+        if (current_worker_index_() != static_cast<int>(queue_index)) {
+            lane.inbox.push_chain(newest, oldest);
+            return;
+        }
+        while (newest) {
+            Job* next = newest->next;
+            newest->next = nullptr;
+            lane.deque.push(newest);
+            newest = next;
+        }
+    }
+
+    /**
+     * @brief Chooses a CPU for every worker, when pinning, and publishes the steal orders for it.
+     */
+    void plan_worker_placement_() {
+        topology_ = CpuTopology::detect();
+        worker_cpus_.assign(num_threads_, -1);
+        std::vector<CpuTopology::Cpu> placement;
+        if (options_.pin_workers) {
+            placement = topology_.placement_order();
+        }
+        for (unsigned int i = 0; i < num_threads_ && !placement.empty(); ++i) {
+            worker_cpus_[i] = placement[i % placement.size()].id;
+        }
+
+        all_workers_.victims.resize(num_threads_);
+        std::iota(all_workers_.victims.begin(), all_workers_.victims.end(), 0);
+        all_workers_.tier_ends = {num_threads_};
+        publish_steal_orders_();
+    }
+
+    /**
+     * @brief Rebuilds the order in which each worker picks steal victims from worker_cpus_.
+     * Victims sharing the thief's physical core come first, then those sharing its last-level
+     * cache, then the rest, so stolen jobs tend to find their data already in a shared cache;
+     * unpinned workers are all in the last tier. Each scan starts a tier at a random victim
+     * (see for_each_victim_), spreading thieves over victims instead of having every idle worker
+     * hit the same queue first.
+     * Workers may be scanning the current orders, so a new set is published and the old ones
+     * are kept until destruction, as with routing tables. Called during construction or with
+     * dedication_mutex_ held.
+     */
+    void publish_steal_orders_() {
+        auto cpu_of = [&](unsigned int worker) -> const CpuTopology::Cpu* {
+            int id = worker_cpus_[worker];
+            auto it = std::lower_bound(topology_.cpus.begin(), topology_.cpus.end(), id, [](const CpuTopology::Cpu& cpu, int value) {
+                return cpu.id < value;
+            });
+            return id != -1 && it != topology_.cpus.end() && it->id == id ? &*it : nullptr;
+        };
+        auto tier = [&](unsigned int thief, unsigned int victim) {
+            const CpuTopology::Cpu* a = cpu_of(thief);
+            const CpuTopology::Cpu* b = cpu_of(victim);
+            if (!a || !b) {
+                return 2;
+            }
+            return a->core == b->core ? 0 : a->cluster == b->cluster ? 1 : 2;
+        };
+
+        auto orders = std::make_unique<std::vector<StealOrder>>(num_threads_);
+        for (unsigned int thief = 0; thief < num_threads_; ++thief) {
+            StealOrder& steal_order = (*orders)[thief];
+            std::vector<unsigned int>& order = steal_order.victims;
+            for (unsigned int step = 1; step < num_threads_; ++step) {
+                order.push_back((thief + step) % num_threads_);
+            }
+            std::stable_sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) {
+                return tier(thief, a) < tier(thief, b);
+            });
+            for (size_t i = 0; i < order.size(); ++i) {
+                if (i + 1 == order.size() || tier(thief, order[i]) != tier(thief, order[i + 1])) {
+                    steal_order.tier_ends.push_back(i + 1);
+                }
+            }
+        }
+        steal_orders_.store(orders.get(), std::memory_order_release);
+        steal_order_tables_.push_back(std::move(orders));
     }
-    
-    // --- END: Integrated Queue Logic and Helpers ---
+
+    /**
+     * @brief Calls `probe(victim)` for each victim in `order` until it returns true.
+     * Tiers are visited nearest first, but each one is scanned from a position picked by `seed`,
+     * wrapping around, so concurrent thieves spread out over the victims of a tier.
+     * @return True if some probe returned true.
+     */
+    template<typename Probe>
+    static bool for_each_victim_(const StealOrder& order, uint64_t seed, Probe&& probe) {
+        size_t tier_begin = 0;
+        for (size_t tier_end : order.tier_ends) {
+            size_t size = tier_end - tier_begin;
+            size_t start = static_cast<size_t>(seed % size);
+            for (size_t i = 0; i < size; ++i) {
+                if (probe(order.victims[tier_begin + (start + i) % size])) {
+                    return true;
+                }
+            }
+            seed /= size;
+            tier_begin = tier_end;
+        }
+        return false;
+    }
+
+    // Next victim-scan seed for `thread_id`: a per-worker xorshift, or a shared counter
+    // that deals non-worker threads round-robin starting points.
+    uint64_t next_steal_seed_(int thread_id) {
+        if (thread_id == -1) {
+            return external_steal_cursor_.fetch_add(1, std::memory_order_relaxed);
+        }
+        uint64_t& state = per_thread_queues_[thread_id]->steal_rng;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+   // --- END: Integrated Queue Logic and Helpers ---
 
     /**
      * @brief The main loop for each worker thread.
      * A thread will first try to execute a job from its own queue. If its queue is empty,
      * it will attempt to steal work from other threads. If no work is found, it will sleep.
      */
-    void worker_thread_loop(unsigned int thread_id, std::atomic<bool>& stop_flag, std::mutex& mtx, std::condition_variable& cv) {
-        while (!stop_flag.load(std::memory_order_acquire)) {
-            if (try_execute_a_job(thread_id)) {
+    void worker_thread_loop(unsigned int thread_id, std::atomic<bool>& stop_flag) {
+        JobPool* pool;
+        StatShard* stats;
+        {
+            std::lock_guard<std::mutex> lock(pools_mutex_);
+            std::unique_ptr<JobPool>& slot = thread_pools_[std::this_thread::get_id()];
+            if (!slot) {
+                slot = std::make_unique<JobPool>();
+            }
+            pool = slot.get();
+            stats = local_stats_locked_();
+        }
+        worker_context_() = WorkerContext{instance_id_, static_cast<int>(thread_id), pool, &stop_flag, nullptr, nullptr, nullptr, stats, 0};
+
+#if NGIN_JOB_FIBERS
+        if (options_.fibers) {
+            // Run the loop on a fiber; we only come back here once that loop sees the stop flag.
+            FiberThread fiber_thread;
+            worker_context_().fiber_thread = &fiber_thread;
+            Fiber* first = take_fiber_();
+            fiber_thread.current = first;
+            first->switch_to(fiber_thread.thread_context);
+            finish_fiber_switch_();
+            worker_context_().fiber_thread = nullptr;
+        } else
+#endif
+        {
+            run_worker_loop_();
+        }
+        logger_->info("Worker thread " + std::to_string(thread_id) + " exiting.");
+    }
+
+    /**
+     * @brief Executes jobs until the calling worker's stop flag is set, sleeping when there are none.
+     * An idle worker spins for a short while before parking, since in a busy frame new jobs usually
+     * arrive within microseconds and a futex round trip would cost more than the wait.
+     * In fiber mode this runs on a fiber that may migrate between worker threads, so the worker's
+     * identity is re-read from the thread on every iteration.
+     */
+    void run_worker_loop_() {
+        int idle_rounds = 0;
+        while (true) {
+            WorkerContext& context = worker_context_();
+            std::atomic<bool>& stop_flag = *context.stop_flag;
+            if (stop_flag.load(std::memory_order_acquire)) {
+                return;
+            }
+#if NGIN_JOB_FIBERS
+            // Parked jobs that can continue come first: they are already part-way through.
+            if (context.fiber_thread && resume_ready_fiber_()) {
+                continue;
+            }
+#endif
+            if (try_execute_a_job(context.index)) {
                 // If we successfully found and ran a job, immediately loop again
                 // to look for more work without waiting.
+                idle_rounds = 0;
+                if (options_.elastic) {
+                    note_busy_(static_cast<unsigned int>(context.index));
+                }
                 continue;
             }
+            if (options_.elastic) {
+                note_idle_(static_cast<unsigned int>(context.index));
+            }
 
-            // If no work was found, go to sleep and wait for a notification.
-            std::unique_lock<std::mutex> lock(worker_mutex_);
-            worker_cv_.wait(lock, [&]() {
-                // Wake up if stop is signaled OR if there might be work to do.
-                return stop_flag.load(std::memory_order_acquire) || total_pending_jobs_count_.load(std::memory_order_acquire) > 0;
-            });
+            // No work found: spin, then yield, before committing to sleep.
+            if (idle_rounds < IDLE_SPIN_ROUNDS) {
+                ++idle_rounds;
+                cpu_relax();
+                continue;
+            }
+            if (idle_rounds < IDLE_SPIN_ROUNDS + IDLE_YIELD_ROUNDS) {
+                ++idle_rounds;
+                std::this_thread::yield();
+                continue;
+            }
+
+            unsigned int index = static_cast<unsigned int>(context.index);
+            if (options_.elastic) {
+                resize_pool_if_due_();
+                if (is_retired_(index)) {
+                    retire_(index, stop_flag);
+                    idle_rounds = 0;
+                    continue;
+                }
+            }
+
+            // Park until a submit picks this worker. Re-check after announcing, so work published
+            // in between is never missed.
+            parking_.prepare_park(index);
+            if (stop_flag.load(std::memory_order_acquire) || has_queued_work_()) {
+                parking_.cancel_park(index);
+            } else {
+                parking_.park(index);
+            }
+            idle_rounds = 0;
         }
-        logger_->info("Worker thread " + std::to_string(thread_id) + " exiting.");
     }
 
+    static constexpr int IDLE_SPIN_ROUNDS = 64;  // Steal attempts separated by a pause instruction
+    static constexpr int IDLE_YIELD_ROUNDS = 8;  // Steal attempts separated by a yield
+
+    // --- Elastic mode ---
+
+    static constexpr uint64_t ELASTIC_CHECK_JOBS = 64;     // A busy worker checks whether the pool is due a resize this often
+    static constexpr double ELASTIC_GROW_IDLE = 0.1;       // Grow when active workers were idle less than this share of the time...
+    static constexpr double ELASTIC_SHRINK_IDLE = 0.5;     // ...and shrink when idle more than this share,
+    static constexpr double ELASTIC_SHRINK_FAILURES = 0.5; // with more than this share of their looks for work failing
+
+    // Counters summed over the active workers when the load was last measured.
+    struct ElasticSample {
+        uint64_t time_ns = 0;
+        uint64_t idle_ns = 0;
+        uint64_t failed_scans = 0;
+        uint64_t jobs_executed = 0;
+    };
+
+    // True if elastic mode has taken `index` out of the pool. Dedicated workers never are.
+    bool is_retired_(unsigned int index) const {
+        if (index < active_workers_.load(std::memory_order_seq_cst)) {
+            return false;
+        }
+        const RoutingTable& routing = *routing_.load(std::memory_order_acquire);
+        return std::find(routing.dedicated.begin(), routing.dedicated.end(), static_cast<int>(index)) == routing.dedicated.end();
+    }
+
+    // The worker found a job: ends its idle spell, and now and then checks whether the pool is due a resize.
+    void note_busy_(unsigned int index) {
+        WorkerQueue& queue = *per_thread_queues_[index];
+        uint64_t since = queue.idle_since_ns.load(std::memory_order_relaxed);
+        if (since != 0) {
+            uint64_t idle = JobTracer::now_ns() - since;
+            queue.idle_ns.store(queue.idle_ns.load(std::memory_order_relaxed) + idle, std::memory_order_relaxed);
+            queue.idle_since_ns.store(0, std::memory_order_relaxed);
+        }
+        if (queue.jobs_executed.load(std::memory_order_relaxed) % ELASTIC_CHECK_JOBS == 0) {
+            resize_pool_if_due_();
+        }
+    }
+
+    // The worker found no job: starts an idle spell unless one is running.
+    void note_idle_(unsigned int index) {
+        WorkerQueue& queue = *per_thread_queues_[index];
+        if (queue.idle_since_ns.load(std::memory_order_relaxed) == 0) {
+            queue.idle_since_ns.store(JobTracer::now_ns(), std::memory_order_relaxed);
+        }
+    }
+
+    // Sleeps until the pool grows back over `index`, with the same handshake as parking.
+    void retire_(unsigned int index, std::atomic<bool>& stop_flag) {
+        per_thread_queues_[index]->idle_since_ns.store(0, std::memory_order_relaxed); // Retired time is not idle time
+        parking_.prepare_retire(index);
+        if (stop_flag.load(std::memory_order_acquire) || !is_retired_(index)) {
+            parking_.cancel_retire(index);
+        } else {
+            parking_.retire(index);
+        }
+    }
+
+    /**
+     * @brief Measures the load once every elastic_interval_us and resizes the pool to match.
+     * Run by whichever worker notices the interval is up. Over the interval, it takes the share
+     * of time active workers spent idle, and the share of their looks for work that found none.
+     * Workers saturated while work is still queued grow the pool by half; workers mostly idle and
+     * failing to find work shrink it by one, so it ramps up quickly and winds down gently.
+     */
+    void resize_pool_if_due_() {
+        uint64_t now = JobTracer::now_ns();
+        if (now < elastic_next_ns_.load(std::memory_order_relaxed) || !elastic_mutex_.try_lock()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(elastic_mutex_, std::adopt_lock);
+        if (now < elastic_next_ns_.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        ElasticSample sample;
+        sample.time_ns = now;
+        uint64_t ongoing_idle_ns = 0;
+        unsigned int active = 0;
+        for (unsigned int i = 0; i < num_threads_; ++i) {
+            const WorkerQueue& queue = *per_thread_queues_[i];
+            sample.idle_ns += queue.idle_ns.load(std::memory_order_relaxed);
+            sample.failed_scans += queue.failed_scans.load(std::memory_order_relaxed);
+            sample.jobs_executed += queue.jobs_executed.load(std::memory_order_relaxed);
+            if (is_retired_(i)) {
+                continue;
+            }
+            ++active;
+            uint64_t since = queue.idle_since_ns.load(std::memory_order_relaxed);
+            if (since != 0 && since < now) {
+                ongoing_idle_ns += now - std::max(since, elastic_sample_.time_ns);
+            }
+        }
+
+        if (elastic_sample_.time_ns != 0 && active > 0) {
+            double elapsed = static_cast<double>(now - elastic_sample_.time_ns) * active;
+            double idle = std::min(1.0, static_cast<double>(sample.idle_ns - elastic_sample_.idle_ns + ongoing_idle_ns) / elapsed);
+            uint64_t failed = sample.failed_scans - elastic_sample_.failed_scans;
+            uint64_t looks = failed + (sample.jobs_executed - elastic_sample_.jobs_executed);
+            double failures = looks > 0 ? static_cast<double>(failed) / static_cast<double>(looks) : 0.0;
+
+            unsigned int target = active_workers_.load(std::memory_order_relaxed);
+            if (idle < ELASTIC_GROW_IDLE && has_queued_work_()) {
+                target = std::min(options_.max_workers, target + std::max(target / 2, 1u));
+            } else if (idle > ELASTIC_SHRINK_IDLE && failures > ELASTIC_SHRINK_FAILURES) {
+                target = std::max(options_.min_workers, target - 1);
+            }
+            set_active_workers_(target);
+        }
+        elastic_sample_ = sample;
+        elastic_next_ns_.store(now + options_.elastic_interval_us * 1000, std::memory_order_relaxed);
+    }
+
+    // Makes workers [0, count) the active ones. Workers above retire the next time they are idle.
+    void set_active_workers_(unsigned int count) {
+        unsigned int previous = active_workers_.exchange(count, std::memory_order_seq_cst);
+        for (unsigned int i = previous; i < count; ++i) {
+            parking_.reinstate(i);
+        }
+    }
+
+#if NGIN_JOB_FIBERS
+    // --- Fiber scheduling ---
+
+    FiberThread* current_fiber_thread_() const {
+        const WorkerContext& context = worker_context_();
+        return context.instance == instance_id_ ? static_cast<FiberThread*>(context.fiber_thread) : nullptr;
+    }
+
+    // Entry point of every worker fiber.
+    static void fiber_main_(void* arg) {
+        JobNgin* self = static_cast<JobNgin*>(arg);
+        self->finish_fiber_switch_();
+        self->run_worker_loop_();
+
+        // Stopping: hand the thread back to its own stack and recycle this fiber from there.
+        FiberThread& thread = *self->current_fiber_thread_();
+        Fiber* fiber = thread.current;
+        thread.pending = FiberSwitch{FiberSwitch::Action::Recycle, fiber, JobHandle()};
+        thread.current = nullptr;
+        swapcontext(&fiber->context(), &thread.thread_context);
+    }
+
+    // Switches the calling worker from its current fiber to `target`.
+    void switch_fiber_(FiberThread& thread, Fiber* target) {
+        Fiber* from = thread.current;
+        thread.current = target;
+        target->switch_to(from->context());
+    }
+
+    // Carries out whatever the fiber we just switched away from asked for.
+    void finish_fiber_switch_() {
+        FiberThread& thread = *current_fiber_thread_();
+        FiberSwitch pending = thread.pending;
+        thread.pending = FiberSwitch();
+
+        switch (pending.action) {
+            case FiberSwitch::Action::Park: {
+                Fiber* fiber = pending.fiber;
+                pending.handle.on_complete([this, fiber]() {
+                    make_fiber_ready_(fiber);
+                });
+                break;
+            }
+            case FiberSwitch::Action::Recycle: {
+                std::lock_guard<std::mutex> lock(fibers_mutex_);
+                pending.fiber->next = free_fibers_;
+                free_fibers_ = pending.fiber;
+                break;
+            }
+            case FiberSwitch::Action::None:
+                break;
+        }
+    }
+
+    // Parks the job running on the calling worker until `handle` completes.
+    void park_current_fiber_(const JobHandle& handle) {
+        FiberThread& thread = *current_fiber_thread_();
+        thread.pending = FiberSwitch{FiberSwitch::Action::Park, thread.current, handle};
+        switch_fiber_(thread, take_fiber_());
+
+        // Resumed by resume_ready_fiber_, possibly on another worker.
+        finish_fiber_switch_();
+    }
+
+    // Switches into a parked fiber whose handle has completed, abandoning the calling idle fiber.
+    bool resume_ready_fiber_() {
+        if (ready_fiber_count_.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+        Fiber* fiber;
+        {
+            std::lock_guard<std::mutex> lock(fibers_mutex_);
+            if (ready_fibers_.empty()) {
+                return false;
+            }
+            fiber = ready_fibers_.front();
+            ready_fibers_.pop_front();
+            ready_fiber_count_.fetch_sub(1, std::memory_order_release);
+        }
+
+        FiberThread& thread = *current_fiber_thread_();
+        thread.pending = FiberSwitch{FiberSwitch::Action::Recycle, thread.current, JobHandle()};
+        switch_fiber_(thread, fiber);
+        return true; // Not reached: a recycled fiber is reset before it runs again.
+    }
+
+    void make_fiber_ready_(Fiber* fiber) {
+        {
+            std::lock_guard<std::mutex> lock(fibers_mutex_);
+            ready_fibers_.push_back(fiber);
+            ready_fiber_count_.fetch_add(1, std::memory_order_release);
+        }
+        wake_workers_(1);
+    }
+
+    // A fiber armed to start a fresh worker loop.
+    Fiber* take_fiber_() {
+        Fiber* fiber;
+        {
+            std::lock_guard<std::mutex> lock(fibers_mutex_);
+            if (free_fibers_) {
+                fiber = free_fibers_;
+                free_fibers_ = fiber->next;
+            } else {
+                all_fibers_.emplace_back(std::make_unique<Fiber>(options_.fiber_stack_size));
+                fiber = all_fibers_.back().get();
+            }
+        }
+        fiber->reset(&JobNgin::fiber_main_, this);
+        return fiber;
+    }
+#endif
+
     /**
      * @brief Attempts to find and execute one job from any queue.
+     * Priorities are strict: every queue is searched for Critical work, own queue first, before
+     * any Normal work is considered, and likewise Normal before Background. A Background job that
+     * is already running is never preempted, so keep individual background jobs short.
      * @param thread_id The ID of the worker thread calling, or -1 for a non-worker thread.
      * @return True if a job was found and executed, false otherwise.
      */
     bool try_execute_a_job(int thread_id) {
-        Job job_to_execute;
-        bool job_found = false;
+        Job* job_to_execute = nullptr;
+        bool stolen = false;
 
-        // 1. If called by a worker, try to pop from its own queue first.
-        if (thread_id != -1 && try_pop_from_queue(thread_id, job_to_execute)) {
-            job_found = true;
-        } else {
-            // 2. If not a worker or own queue is empty, try to steal from others.
-            for (unsigned int i = 0; i < num_threads_; ++i) {
-                if (i == thread_id) continue;
-
-                if (try_steal_from_queue(i, job_to_execute)) {
-                    job_found = true;
-                    break;
+        for (size_t lane = 0; lane < JOB_PRIORITY_COUNT && !job_to_execute; ++lane) {
+            // 1. If called by a worker, try to pop from its own queue first.
+            if (thread_id != -1) {
+                job_to_execute = try_pop_from_queue(thread_id, lane);
+            }
+            if (!job_to_execute) {
+                // 2. If not a worker or own queue is empty, try to steal from others,
+                //    nearest in the cache hierarchy first.
+                const StealOrder& order = thread_id == -1 ? all_workers_ : (*steal_orders_.load(std::memory_order_acquire))[thread_id];
+                size_t attempts = 0;
+                stolen = for_each_victim_(order, next_steal_seed_(thread_id), [&](unsigned int victim) {
+                    ++attempts;
+                    job_to_execute = try_steal_from_queue(victim, thread_id, lane);
+                    return job_to_execute != nullptr;
+                });
+                if (thread_id != -1) {
+                    per_thread_queues_[thread_id]->steal_attempts.fetch_add(attempts, std::memory_order_relaxed);
                 }
             }
         }
-        
-        if (job_found) {
-            execute_job(job_to_execute);
+
+        if (job_to_execute) {
+            if (thread_id != -1) {
+                per_thread_queues_[thread_id]->jobs_executed.fetch_add(1, std::memory_order_relaxed);
+            }
+            execute_job(job_to_execute, stolen);
             return true;
         }
 
+        if (thread_id != -1) {
+            per_thread_queues_[thread_id]->failed_scans.fetch_add(1, std::memory_order_relaxed);
+        }
         return false;
     }
 
     /**
-     * @brief Executes a job and decrements its associated counters.
+     * @brief Executes a job, decrements its associated counters and frees it.
      * @param job The job to execute.
+     * @param stolen Whether the job came from another worker's queue, for tracing.
      */
-    void execute_job(Job& job) {
-        job.task();
-        job.handle.get_counter()->fetch_sub(1, std::memory_order_release);
-            
-        job_type_counts_[job.type].fetch_sub(1, std::memory_order_release);
-        total_pending_jobs_count_.fetch_sub(1, std::memory_order_release);
-        
-        manager_cv_.notify_all();
+    void execute_job(Job* job, bool stolen = false) {
+        if (tracer_.active()) {
+            execute_traced_job_(job, stolen);
+            return;
+        }
+        run_job_(job);
+    }
+
+    void execute_traced_job_(Job* job, bool stolen) {
+        JobTraceEvent event;
+        event.worker = current_worker_index_();
+        event.type = job->type;
+        event.priority = job->priority;
+        event.handle_id = job->handle.id();
+        event.stolen = stolen;
+        event.start_ns = JobTracer::now_ns();
+        run_job_(job);
+        event.end_ns = JobTracer::now_ns();
+
+        // Look the buffer up afresh: in fiber mode the job may have finished on another thread.
+        WorkerContext& context = worker_context_();
+        if (context.instance != instance_id_) {
+            local_pool_(); // Claims the context for this JobNgin
+        }
+        if (!context.trace) {
+            context.trace = tracer_.register_thread(context.index);
+        }
+        context.trace->record(event);
+    }
+
+    // True if `job` should be dropped rather than run: its handle was cancelled or its deadline passed.
+    static bool should_skip_(const Job* job) {
+        return job->handle.is_cancelled()
+            || (job->deadline != NO_JOB_DEADLINE && std::chrono::steady_clock::now() > job->deadline);
+    }
+
+    void run_job_(Job* job) {
+        bool skipped = should_skip_(job);
+        if (!skipped) {
+            job->task();
+        }
+
+        // Recycle the job (destroying whatever its task captured) before signalling completion,
+        // so a waiter never outlives state the task still references.
+        job->task.reset();
+        JobType type = job->type;
+        JobHandle handle = std::move(job->handle);
+        release_job_(job);
+        StatShard& stats = local_stats_();
+        StatShard::add(stats.completed, type, 1);
+        if (skipped) {
+            StatShard::add(stats.skipped, type, 1);
+        }
+
+        // May release dependent batches onto the queues from this thread.
+        handle.complete();
     }
 
     // --- Member Variables ---
 
     ngin::debug::Logger* logger_ = nullptr;
+    JobNginOptions options_;
     unsigned int num_threads_;
     std::vector<std::unique_ptr<ngin::jobs::Thread>> worker_threads_;
     
-    std::vector<std::deque<Job>> per_thread_queues_;
-    mutable std::vector<std::mutex> per_queue_mutexes_;
+    std::vector<std::unique_ptr<WorkerQueue>> per_thread_queues_;
     std::atomic<unsigned int> submit_thread_index_;
 
-    // NEW: Members for thread dedication
-    mutable std::mutex dedication_mutex_;
-    std::map<JobType, unsigned int> thread_dedications_;
-    std::vector<unsigned int> general_purpose_thread_indices_;
+    // Which worker each job type is queued on. Submitters read the current table without locking;
+    // dedicate_thread_to_job_type publishes a modified copy (read-copy-update). Replaced tables are
+    // kept, since a submitter may still be reading one, and freed with the JobNgin.
+    struct RoutingTable {
+        std::array<int, JOB_TYPE_COUNT> dedicated;  // Worker for each JobType, -1 if none
+        std::vector<unsigned int> general;          // Workers taking undedicated types
+        unsigned int num_workers;
+
+        // The general-purpose worker for round-robin `ticket` among the first `count` (see
+        // general_count); any worker once all are dedicated.
+        unsigned int general_worker(unsigned int ticket, size_t count) const {
+            return general.empty() ? ticket % num_workers : general[ticket % count];
+        }
+        // General-purpose workers below `active_workers`, the ones elastic mode keeps running,
+        // or all of them if none is. `general` is sorted, so these come first.
+        size_t general_count(unsigned int active_workers) const {
+            if (general.empty()) {
+                return num_workers;
+            }
+            size_t count = static_cast<size_t>(std::lower_bound(general.begin(), general.end(), active_workers) - general.begin());
+            return count > 0 ? count : general.size();
+        }
+    };
+
+    mutable std::mutex dedication_mutex_; // Serializes dedicate_thread_to_job_type and guards routing_tables_
+    std::atomic<const RoutingTable*> routing_{nullptr};
+    std::vector<std::unique_ptr<RoutingTable>> routing_tables_; // Every table ever published; the last is current
+    std::vector<int> worker_cpus_; // CPU each worker is pinned to, -1 if unpinned. Guarded by dedication_mutex_ after startup
+
+    StealOrder all_workers_;                  // 0..num_threads_-1 as one tier, the victim order for non-worker threads
+    std::atomic<const std::vector<StealOrder>*> steal_orders_{nullptr}; // Victims per worker, nearest first
+    std::vector<std::unique_ptr<std::vector<StealOrder>>> steal_order_tables_; // Every set ever published; the last is current
+    CpuTopology topology_;
+    std::atomic<uint64_t> external_steal_cursor_{0}; // Scan seed for non-worker threads
+
+    ParkingLot parking_; // Where idle workers sleep, one slot each
+
+    std::array<std::atomic<JobPriority>, JOB_TYPE_COUNT> type_priorities_; // Priority each JobType is submitted at
+
+    const uint64_t instance_id_;
+
+    JobTracer tracer_;
+
+    MainThreadQueue main_thread_queue_; // Bound to the constructing thread
 
-    std::mutex worker_mutex_;
-    std::condition_variable worker_cv_;
-    std::condition_variable manager_cv_;
+    // Elastic mode: workers [0, active_workers_) take work. Always num_threads_ otherwise.
+    std::atomic<unsigned int> active_workers_{0};
+    std::mutex elastic_mutex_;               // Held by the worker measuring the load
+    std::atomic<uint64_t> elastic_next_ns_{0}; // When the load is next measured
+    ElasticSample elastic_sample_;           // The last measurement. Guarded by elastic_mutex_
 
-    std::map<JobType, std::atomic<int>> job_type_counts_;
-    std::atomic<int> total_pending_jobs_count_;
+    // Fiber mode: every fiber ever created, idle fibers, and parked fibers ready to resume.
+    std::atomic<int> ready_fiber_count_{0};
+#if NGIN_JOB_FIBERS
+    std::mutex fibers_mutex_;
+    std::vector<std::unique_ptr<Fiber>> all_fibers_;
+    Fiber* free_fibers_ = nullptr;
+    std::deque<Fiber*> ready_fibers_;
+#endif
+    mutable std::mutex pools_mutex_;
+    std::map<std::thread::id, std::unique_ptr<JobPool>> thread_pools_; // One job pool per submitting or worker thread
+    std::map<std::thread::id, std::unique_ptr<StatShard>> thread_stats_; // One statistics shard per submitting or worker thread
+    std::map<std::thread::id, std::unique_ptr<FrameArena>> thread_arenas_; // Frame arenas, created on first use
+    std::atomic<uint64_t> frame_epoch_{0}; // Frames marked so far; arenas reset when it moves on
 };
 
 } // namespace jobs
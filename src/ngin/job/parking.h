@@ -0,0 +1,175 @@
+#ifndef JOB_PARKING_H
+#define JOB_PARKING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace ngin {
+namespace jobs {
+
+// Tells the CPU we are busy-waiting, without giving up the thread.
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+/**
+ * @brief Per-worker sleep slots, so idle workers can be woken one at a time.
+ *
+ * Each worker owns a cache-line padded slot and sleeps on it with
+ * std::atomic::wait (a futex on Linux). Parking is two-phase, to rule out lost
+ * wakeups without a shared mutex:
+ *
+ *   worker: prepare_park(i); if (work is visible) cancel_park(i); else park(i);
+ *   waker:  publish work; unpark(n);
+ *
+ * prepare_park and unpark each issue a full fence between their own store and
+ * load, so either the waker sees the worker as parked, or the worker's re-check
+ * sees the new work. When nobody is parked, unpark is a fence and one load.
+ *
+ * A worker can also retire (elastic mode), with the same two-phase handshake:
+ * it sleeps like a parked worker, but unpark passes it over and is not slowed
+ * down by it. Only reinstate() or unpark_all() wakes a retired worker.
+ */
+class ParkingLot {
+public:
+    explicit ParkingLot(size_t workers)
+        : spots_(new Spot[workers]), num_spots_(workers) {}
+
+    ParkingLot(const ParkingLot&) = delete;
+    ParkingLot& operator=(const ParkingLot&) = delete;
+
+    // Announces that `worker` is about to sleep. It must re-check for work before calling park().
+    void prepare_park(size_t worker) {
+        spots_[worker].state.store(PARKED, std::memory_order_relaxed);
+        parked_count_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    // Backs out of prepare_park after the re-check found work.
+    void cancel_park(size_t worker) {
+        spots_[worker].state.store(RUNNING, std::memory_order_relaxed);
+        parked_count_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Sleeps until unpark() picks this worker. Returns immediately if it already has.
+    void park(size_t worker) {
+        std::atomic<uint32_t>& state = spots_[worker].state;
+        while (state.load(std::memory_order_acquire) == PARKED) {
+            state.wait(PARKED, std::memory_order_acquire);
+        }
+        state.store(RUNNING, std::memory_order_relaxed);
+        parked_count_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Like prepare_park, for a worker about to retire. It must re-check that it should still
+    // retire, then call cancel_retire() or retire().
+    void prepare_retire(size_t worker) {
+        spots_[worker].state.store(RETIRED, std::memory_order_relaxed);
+        retired_count_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void cancel_retire(size_t worker) {
+        spots_[worker].state.store(RUNNING, std::memory_order_relaxed);
+        retired_count_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Sleeps until reinstate() or unpark_all() wakes this worker.
+    void retire(size_t worker) {
+        std::atomic<uint32_t>& state = spots_[worker].state;
+        while (state.load(std::memory_order_acquire) == RETIRED) {
+            state.wait(RETIRED, std::memory_order_acquire);
+        }
+        state.store(RUNNING, std::memory_order_relaxed);
+        retired_count_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Wakes up to `count` parked workers. Call after publishing the work they should pick up.
+     * Sleepers are scanned from a rotating start, so wakeups are spread across workers.
+     */
+    void unpark(size_t count) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (count == 0 || parked_count_.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        size_t start = next_scan_.fetch_add(1, std::memory_order_relaxed);
+        for (size_t i = 0; i < num_spots_ && count > 0; ++i) {
+            std::atomic<uint32_t>& state = spots_[(start + i) % num_spots_].state;
+            uint32_t expected = PARKED;
+            if (state.load(std::memory_order_relaxed) == PARKED
+                && state.compare_exchange_strong(expected, NOTIFIED, std::memory_order_release, std::memory_order_relaxed)) {
+                state.notify_one();
+                --count;
+            }
+        }
+    }
+
+    /**
+     * @brief Wakes `worker` if it is retired. Call after making it one of the active workers again;
+     * the fence pairs with the one in prepare_retire, so a worker about to retire sees that it
+     * no longer should.
+     */
+    void reinstate(size_t worker) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::atomic<uint32_t>& state = spots_[worker].state;
+        uint32_t expected = RETIRED;
+        if (state.compare_exchange_strong(expected, NOTIFIED, std::memory_order_release, std::memory_order_relaxed)) {
+            state.notify_one();
+        }
+    }
+
+    // Wakes every sleeping worker, retired or not, e.g. to shut down.
+    void unpark_all() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (size_t i = 0; i < num_spots_; ++i) {
+            std::atomic<uint32_t>& state = spots_[i].state;
+            uint32_t current = state.load(std::memory_order_relaxed);
+            while ((current == PARKED || current == RETIRED)
+                   && !state.compare_exchange_weak(current, NOTIFIED, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+            if (current == PARKED || current == RETIRED) {
+                state.notify_one();
+            }
+        }
+    }
+
+    // Workers currently parked or retired, or about to be.
+    size_t parked() const {
+        return parked_count_.load(std::memory_order_relaxed) + retired_count_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr uint32_t RUNNING = 0;
+    static constexpr uint32_t PARKED = 1;
+    static constexpr uint32_t NOTIFIED = 2;
+    static constexpr uint32_t RETIRED = 3;
+
+    struct alignas(64) Spot {
+        std::atomic<uint32_t> state{RUNNING};
+    };
+
+    std::unique_ptr<Spot[]> spots_;
+    size_t num_spots_;
+    alignas(64) std::atomic<size_t> parked_count_{0};
+    std::atomic<size_t> retired_count_{0};
+    std::atomic<size_t> next_scan_{0};
+};
+
+}
+}
+
+#endif // JOB_PARKING_H
@@ -0,0 +1,163 @@
+#ifndef JOB_PIPELINE_H
+#define JOB_PIPELINE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include <ngin/job/ngin.h>
+
+namespace ngin {
+namespace jobs {
+
+// Settings for a FramePipeline.
+struct FramePipelineOptions {
+    // Frames whose simulation may be in flight at once. 1 simulates and presents each frame back
+    // to back; 2 simulates frame N+1 on the workers while the main thread presents frame N.
+    size_t depth = 2;
+    // Every this many frames, drain the pipeline and run the sync callback with no simulation
+    // running. 0 only drains on flush().
+    size_t sync_interval = 0;
+    JobType type = JobType::Other; // Type the simulation jobs are submitted as
+};
+
+/**
+ * @brief The stages of one frame, as run by a FramePipeline.
+ * Only `simulate` runs on a worker; the others run on the thread calling advance().
+ */
+template<typename State>
+struct FrameStages {
+    // Fills in per-frame input, e.g. a snapshot of the input devices, before the frame is simulated.
+    // Optional. `next` still holds whatever the frame that last used its slot left there.
+    std::function<void(State& next, uint64_t frame)> stage;
+    // Computes the frame from the one before it. May submit and wait for jobs of its own.
+    std::function<void(const State& previous, State& next, uint64_t frame)> simulate;
+    // Consumes a simulated frame, e.g. by issuing its draw calls.
+    std::function<void(const State& state, uint64_t frame)> present;
+    // Runs at each sync point, with every frame presented and nothing simulating. Optional.
+    std::function<void()> sync;
+};
+
+/**
+ * @brief Overlaps simulating upcoming frames with presenting earlier ones.
+ *
+ * Each frame lives in its own State slot: depth + 1 of them, so the frame being simulated
+ * never shares a slot with the one it reads or with any frame not yet presented. Every
+ * advance() stages and submits the next frame's simulation, which depends on the previous
+ * one's, then, once `depth` frames are in flight, waits for the oldest and presents it.
+ *
+ * A frame's simulation can run across a JobNgin::mark_frame(), so state that must reach
+ * present() belongs in the State itself, not in a frame arena.
+ *
+ * Not thread-safe: drive it from one thread, normally the main loop.
+ */
+template<typename State>
+class FramePipeline {
+public:
+    FramePipeline(JobNgin& job_ngin, FrameStages<State> stages, FramePipelineOptions options = FramePipelineOptions(), State initial = State())
+        : job_ngin_(job_ngin),
+          stages_(std::move(stages)),
+          options_(options)
+    {
+        options_.depth = std::max<size_t>(options_.depth, 1);
+        states_.resize(options_.depth + 1);
+        states_[0] = std::move(initial);
+    }
+
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    // Waits for simulations still in flight, which reference our slots, without presenting them.
+    ~FramePipeline() {
+        for (JobHandle& handle : in_flight_) {
+            job_ngin_.wait_for(handle);
+        }
+    }
+
+    /**
+     * @brief Starts simulating the next frame, and presents the oldest one if the pipeline is full.
+     * @return The number of the frame just submitted; the first frame is 1.
+     */
+    uint64_t advance() {
+        uint64_t frame = ++frames_submitted_;
+        State& previous = slot_(frame - 1);
+        State& next = slot_(frame);
+        if (stages_.stage) {
+            stages_.stage(next, frame);
+        }
+
+        std::vector<std::function<void()>> simulate;
+        simulate.push_back([this, &previous, &next, frame]() {
+            stages_.simulate(previous, next, frame);
+        });
+        std::vector<JobHandle> dependencies;
+        if (!in_flight_.empty()) {
+            dependencies.push_back(in_flight_.back());
+        }
+        in_flight_.push_back(job_ngin_.submit_jobs(std::move(simulate), options_.type, dependencies));
+
+        if (in_flight_.size() >= options_.depth) {
+            present_oldest_();
+        }
+        if (options_.sync_interval > 0 && frame % options_.sync_interval == 0) {
+            flush();
+        }
+        return frame;
+    }
+
+    // Waits for and presents every frame in flight, then runs the sync stage.
+    void flush() {
+        while (!in_flight_.empty()) {
+            present_oldest_();
+        }
+        if (stages_.sync) {
+            stages_.sync();
+        }
+    }
+
+    size_t frames_in_flight() const {
+        return in_flight_.size();
+    }
+
+    uint64_t frames_submitted() const {
+        return frames_submitted_;
+    }
+
+    uint64_t frames_presented() const {
+        return frames_submitted_ - in_flight_.size();
+    }
+
+    const FramePipelineOptions& options() const {
+        return options_;
+    }
+
+private:
+    State& slot_(uint64_t frame) {
+        return states_[frame % states_.size()];
+    }
+
+    void present_oldest_() {
+        uint64_t frame = frames_presented() + 1;
+        job_ngin_.wait_for(in_flight_.front());
+        in_flight_.pop_front();
+        if (stages_.present) {
+            stages_.present(slot_(frame), frame);
+        }
+    }
+
+    JobNgin& job_ngin_;
+    FrameStages<State> stages_;
+    FramePipelineOptions options_;
+    std::vector<State> states_;      // Slot of frame N is N % (depth + 1); the initial state is frame 0's
+    std::deque<JobHandle> in_flight_; // Simulations not yet presented, oldest first
+    uint64_t frames_submitted_ = 0;
+};
+
+}
+}
+
+#endif // JOB_PIPELINE_H
@@ -0,0 +1,81 @@
+#ifndef JOB_POOL_H
+#define JOB_POOL_H
+
+#include <memory>
+#include <vector>
+
+#include <ngin/job/job.h>
+#include <ngin/job/collections/inbox.h>
+
+namespace ngin {
+namespace jobs {
+
+/**
+ * @brief A per-thread free list of Job records.
+ *
+ * Only the owning thread acquires from a pool. Any thread may release a job back
+ * to it: the owner pushes onto its private free list, everyone else onto a
+ * lock-free return inbox that the owner reclaims in one exchange when its private
+ * list runs dry. New records are allocated in blocks, so once a frame's worth of
+ * jobs has been seen, acquire and release never touch the heap.
+ */
+class JobPool {
+public:
+    static constexpr size_t BLOCK_SIZE = 256;
+
+    JobPool() = default;
+
+    JobPool(const JobPool&) = delete;
+    JobPool& operator=(const JobPool&) = delete;
+
+    // Owner thread only.
+    Job* acquire() {
+        if (!free_) {
+            free_ = returned_.take_all();
+            if (!free_) {
+                grow_();
+            }
+        }
+        Job* job = free_;
+        free_ = job->next;
+        job->next = nullptr;
+        return job;
+    }
+
+    /**
+     * @brief Returns a finished job to this pool. The job's task must already be reset.
+     * @param owner_thread True when called from the thread that owns this pool.
+     */
+    void release(Job* job, bool owner_thread) {
+        if (owner_thread) {
+            job->next = free_;
+            free_ = job;
+        } else {
+            returned_.push(job);
+        }
+    }
+
+    size_t capacity() const {
+        return blocks_.size() * BLOCK_SIZE;
+    }
+
+private:
+    void grow_() {
+        blocks_.emplace_back(std::make_unique<Job[]>(BLOCK_SIZE));
+        Job* block = blocks_.back().get();
+        for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+            block[i].pool = this;
+            block[i].next = i + 1 < BLOCK_SIZE ? &block[i + 1] : free_;
+        }
+        free_ = block;
+    }
+
+    Job* free_ = nullptr;                     // Owner-only
+    ParallelInbox<Job> returned_;             // Released by other threads
+    std::vector<std::unique_ptr<Job[]>> blocks_;
+};
+
+}
+}
+
+#endif // JOB_POOL_H
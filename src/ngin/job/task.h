@@ -0,0 +1,225 @@
+#ifndef JOB_TASK_H
+#define JOB_TASK_H
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include <ngin/job/ngin.h>
+
+namespace ngin {
+namespace jobs {
+
+template<typename T = void>
+class Task;
+
+template<typename T>
+JobHandle spawn(JobNgin& job_ngin, Task<T> task, JobType type = JobType::Other);
+
+namespace detail {
+
+// Storage shared by Task promises for the result, the awaiting coroutine and detached completion.
+struct TaskPromiseBase {
+    std::coroutine_handle<> continuation; // Resumed when this task finishes, if awaited
+    std::exception_ptr exception;
+    std::optional<JobHandle> detached;    // Set by spawn(): completed instead of resuming anyone
+
+    std::suspend_always initial_suspend() noexcept {
+        return {};
+    }
+
+    // Hands control straight to whoever awaited us, or signals spawn()'s handle and frees the frame.
+    struct FinalAwaiter {
+        bool await_ready() noexcept {
+            return false;
+        }
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> self) noexcept {
+            TaskPromiseBase& promise = self.promise();
+            if (promise.continuation) {
+                return promise.continuation;
+            }
+            if (promise.detached) {
+                if (promise.exception) {
+                    std::terminate(); // Nobody is left to observe it, as with an exception escaping a job.
+                }
+                JobHandle handle = *promise.detached;
+                self.destroy();
+                handle.complete();
+            }
+            return std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+    };
+
+    FinalAwaiter final_suspend() noexcept {
+        return {};
+    }
+
+    void unhandled_exception() noexcept {
+        exception = std::current_exception();
+    }
+};
+
+template<typename T>
+struct TaskPromise : TaskPromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object() noexcept;
+
+    template<typename U>
+    void return_value(U&& result) {
+        value.emplace(std::forward<U>(result));
+    }
+
+    T take_result() {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+        return std::move(*value);
+    }
+};
+
+template<>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object() noexcept;
+
+    void return_void() noexcept {}
+
+    void take_result() {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+};
+
+}
+
+/**
+ * @brief A lazily started coroutine whose suspension points are job system events.
+ *
+ * A Task does nothing until it is awaited by another coroutine or handed to spawn().
+ * Inside it, `co_await handle` suspends until a JobHandle completes and `co_await task`
+ * runs a child Task to completion. Suspension never blocks a thread: the coroutine is
+ * resumed by whichever thread completes the awaited handle, normally the worker that
+ * ran its last job, so a multi-stage pipeline hops between workers without any of them
+ * sitting in wait_for.
+ *
+ * Tasks are move-only and own their coroutine frame until it is awaited or spawned.
+ */
+template<typename T>
+class Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+
+    Task(Task&& other) noexcept : coroutine_(std::exchange(other.coroutine_, nullptr)) {}
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (coroutine_) {
+                coroutine_.destroy();
+            }
+            coroutine_ = std::exchange(other.coroutine_, nullptr);
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        if (coroutine_) {
+            coroutine_.destroy();
+        }
+    }
+
+    // Starts the task and suspends the awaiting coroutine until it finishes, then yields its result.
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> coroutine;
+
+            bool await_ready() noexcept {
+                return false;
+            }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                coroutine.promise().continuation = awaiting;
+                return coroutine;
+            }
+            T await_resume() {
+                return coroutine.promise().take_result();
+            }
+        };
+        return Awaiter{coroutine_};
+    }
+
+private:
+    friend struct detail::TaskPromise<T>;
+    template<typename U>
+    friend JobHandle spawn(JobNgin& job_ngin, Task<U> task, JobType type);
+
+    explicit Task(std::coroutine_handle<promise_type> coroutine) : coroutine_(coroutine) {}
+
+    std::coroutine_handle<promise_type> coroutine_;
+};
+
+namespace detail {
+
+template<typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+}
+
+/**
+ * @brief Starts `task` as a job on `job_ngin` and lets it run to completion on its own.
+ * The coroutine frame frees itself when the task finishes. A result, if any, is discarded.
+ * @return A handle that completes when the task does, for wait_for or as a dependency.
+ */
+template<typename T>
+JobHandle spawn(JobNgin& job_ngin, Task<T> task, JobType type) {
+    JobHandle done;
+    done.add_pending(1);
+
+    std::coroutine_handle<detail::TaskPromise<T>> coroutine = std::exchange(task.coroutine_, nullptr);
+    coroutine.promise().detached = done;
+
+    JobHandle started;
+    job_ngin.submit([coroutine]() {
+        coroutine.resume();
+    }, type, started);
+    return done;
+}
+
+}
+}
+
+/**
+ * @brief Lets a coroutine `co_await` a JobHandle.
+ * Completes immediately if the handle already has; otherwise the coroutine is resumed
+ * on the thread that completes it.
+ */
+inline auto operator co_await(JobHandle handle) noexcept {
+    struct Awaiter {
+        JobHandle handle;
+
+        bool await_ready() const noexcept {
+            return handle.is_complete();
+        }
+        bool await_suspend(std::coroutine_handle<> coroutine) {
+            return handle.try_on_complete([coroutine]() {
+                coroutine.resume();
+            });
+        }
+        void await_resume() const noexcept {}
+    };
+    return Awaiter{handle};
+}
+
+#endif // JOB_TASK_H
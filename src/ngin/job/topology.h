@@ -0,0 +1,161 @@
+#ifndef JOB_TOPOLOGY_H
+#define JOB_TOPOLOGY_H
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ngin {
+namespace jobs {
+
+/**
+ * @brief Where each logical CPU sits in the core and cache hierarchy.
+ *
+ * Read from /sys/devices/system/cpu on Linux. Where that is unavailable every CPU
+ * is reported as its own core in a single cache cluster, so callers can use the
+ * result unconditionally.
+ */
+struct CpuTopology {
+    struct Cpu {
+        int id;         // Logical CPU number, as used by sched_setaffinity
+        int core;       // Physical core; SMT siblings share it
+        int cluster;    // Last-level cache group; CPUs sharing an L3 share it
+        int smt_rank;   // 0 for the first hardware thread of its core, 1 for the next, ...
+    };
+
+    std::vector<Cpu> cpus; // Sorted by id
+
+    static CpuTopology detect(const std::string& root = "/sys/devices/system/cpu") {
+        CpuTopology topology;
+        std::vector<int> online = parse_cpu_list(read_line_(root + "/online"));
+#if defined(__linux__)
+        // Leave out CPUs this process may not run on (taskset, cgroups).
+        cpu_set_t allowed;
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+            online.erase(std::remove_if(online.begin(), online.end(), [&](int cpu) {
+                return cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, &allowed);
+            }), online.end());
+        }
+#endif
+        if (online.empty()) {
+            unsigned int count = std::max(1u, std::thread::hardware_concurrency());
+            for (unsigned int i = 0; i < count; ++i) {
+                topology.cpus.push_back(Cpu{static_cast<int>(i), static_cast<int>(i), 0, 0});
+            }
+            return topology;
+        }
+
+        std::map<std::pair<int, int>, int> cores; // (package, core_id) -> core index
+        for (int id : online) {
+            std::string dir = root + "/cpu" + std::to_string(id);
+            int package = to_int_(read_line_(dir + "/topology/physical_package_id"), 0);
+            int core_id = to_int_(read_line_(dir + "/topology/core_id"), id);
+            int core = cores.emplace(std::make_pair(package, core_id), static_cast<int>(cores.size())).first->second;
+
+            // The cluster is named after the lowest CPU sharing the last-level cache found.
+            int cluster = package;
+            int best_level = 0;
+            for (int index = 0; ; ++index) {
+                std::string cache = dir + "/cache/index" + std::to_string(index);
+                std::string level = read_line_(cache + "/level");
+                if (level.empty()) {
+                    break;
+                }
+                std::vector<int> shared = parse_cpu_list(read_line_(cache + "/shared_cpu_list"));
+                if (to_int_(level, 0) >= best_level && !shared.empty()) {
+                    best_level = to_int_(level, 0);
+                    cluster = shared.front();
+                }
+            }
+            topology.cpus.push_back(Cpu{id, core, cluster, 0});
+        }
+
+        std::map<int, int> next_rank; // core -> hardware threads seen so far
+        for (Cpu& cpu : topology.cpus) {
+            cpu.smt_rank = next_rank[cpu.core]++;
+        }
+        return topology;
+    }
+
+    /**
+     * @brief The order in which to place workers on CPUs.
+     * One hardware thread of every physical core comes first, so workers only share a core once
+     * every core has one; within that, CPUs of one cache cluster stay together.
+     */
+    std::vector<Cpu> placement_order() const {
+        std::vector<Cpu> order = cpus;
+        std::stable_sort(order.begin(), order.end(), [](const Cpu& a, const Cpu& b) {
+            if (a.smt_rank != b.smt_rank) return a.smt_rank < b.smt_rank;
+            if (a.cluster != b.cluster) return a.cluster < b.cluster;
+            return a.core < b.core;
+        });
+        return order;
+    }
+
+    // Parses the kernel's CPU list format, e.g. "0-3,8,10-11".
+    static std::vector<int> parse_cpu_list(const std::string& list) {
+        std::vector<int> result;
+        std::stringstream stream(list);
+        std::string range;
+        while (std::getline(stream, range, ',')) {
+            size_t dash = range.find('-');
+            int first = to_int_(range.substr(0, dash), -1);
+            int last = dash == std::string::npos ? first : to_int_(range.substr(dash + 1), -1);
+            for (int cpu = first; cpu >= 0 && cpu <= last; ++cpu) {
+                result.push_back(cpu);
+            }
+        }
+        return result;
+    }
+
+private:
+    static std::string read_line_(const std::string& path) {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    static int to_int_(const std::string& text, int fallback) {
+        try {
+            return text.empty() ? fallback : std::stoi(text);
+        } catch (const std::exception&) {
+            return fallback;
+        }
+    }
+};
+
+/**
+ * @brief Restricts a thread to a single logical CPU.
+ * @return False if the platform has no affinity support or the call failed.
+ */
+inline bool pin_thread_to_cpu(std::thread::native_handle_type thread, int cpu) {
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+#else
+    (void)thread;
+    (void)cpu;
+    return false;
+#endif
+}
+
+}
+}
+
+#endif // JOB_TOPOLOGY_H
@@ -0,0 +1,229 @@
+#ifndef JOB_TRACE_H
+#define JOB_TRACE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <ngin/job/job.h>
+
+namespace ngin {
+namespace jobs {
+
+// One executed job, as recorded by the tracer.
+struct JobTraceEvent {
+    uint64_t start_ns;   // JobTracer::now_ns() when the task started
+    uint64_t end_ns;     // ... and when its handle was signalled
+    uint32_t handle_id;  // JobHandle::id() of the handle the job counted against
+    int32_t worker;      // Worker that ran the job, -1 for a non-worker thread
+    JobType type;
+    JobPriority priority;
+    bool stolen;         // Taken from another worker's queue rather than the runner's own
+};
+
+/**
+ * @brief A single-writer ring of JobTraceEvents, owned by one thread.
+ *
+ * The owner records without locks or allocation; once full, the oldest events are
+ * overwritten. snapshot() may run on any thread and drops any event the writer
+ * lapped while it was being copied.
+ */
+class JobTraceBuffer {
+public:
+    JobTraceBuffer(size_t capacity, int32_t worker, uint32_t track)
+        : events_(round_up_pow2_(capacity)), mask_(events_.size() - 1), worker_(worker), track_(track) {}
+
+    // Owner thread only.
+    void record(const JobTraceEvent& event) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        events_[head & mask_] = event;
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    // Forgets everything recorded so far.
+    void rewind() {
+        base_.store(head_.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+
+    // Appends the retained events to `out`, oldest first.
+    void snapshot(std::vector<JobTraceEvent>& out) const {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        uint64_t first = std::max(base_.load(std::memory_order_relaxed), head > events_.size() ? head - events_.size() : 0);
+        size_t start = out.size();
+        for (uint64_t i = first; i < head; ++i) {
+            out.push_back(events_[i & mask_]);
+        }
+
+        // Anything the writer has since lapped may be torn.
+        uint64_t after = head_.load(std::memory_order_acquire);
+        uint64_t valid_from = after > events_.size() ? after - events_.size() : 0;
+        if (valid_from > first) {
+            size_t torn = static_cast<size_t>(std::min(valid_from, head) - first);
+            out.erase(out.begin() + start, out.begin() + start + torn);
+        }
+    }
+
+    int32_t worker() const { return worker_; }
+    uint32_t track() const { return track_; }
+
+private:
+    static size_t round_up_pow2_(size_t n) {
+        size_t p = 1;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    std::vector<JobTraceEvent> events_;
+    size_t mask_;
+    int32_t worker_;
+    uint32_t track_; // Chrome trace thread id
+    alignas(64) std::atomic<uint64_t> head_{0}; // Events ever recorded
+    std::atomic<uint64_t> base_{0};             // First event of the current capture
+};
+
+/**
+ * @brief Records job timelines over a range of frames and exports them as Chrome trace JSON.
+ *
+ * Capturing is armed with start(frame_count) and begins at the next mark_frame(); it
+ * stops by itself once that many frames have been marked. The output loads in
+ * chrome://tracing and ui.perfetto.dev, with one track per thread and one for frames.
+ */
+class JobTracer {
+public:
+    explicit JobTracer(size_t events_per_thread) : events_per_thread_(events_per_thread) {}
+
+    static uint64_t now_ns() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // True while jobs should be recorded. Checked around every job, so it is a single relaxed load.
+    bool active() const {
+        return active_.load(std::memory_order_relaxed);
+    }
+
+    // True from start() until the requested frames have been captured.
+    bool pending() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return armed_frames_ > 0 || remaining_frames_ > 0;
+    }
+
+    // Creates the calling thread's buffer. Done once per thread.
+    JobTraceBuffer* register_thread(int32_t worker) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffers_.emplace_back(std::make_unique<JobTraceBuffer>(events_per_thread_, worker, static_cast<uint32_t>(buffers_.size() + 1)));
+        return buffers_.back().get();
+    }
+
+    void start(size_t frame_count) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        armed_frames_ = frame_count;
+    }
+
+    // Marks a frame boundary. Call once per frame from the thread that drives the frame loop.
+    void mark_frame() {
+        uint64_t now = now_ns();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (remaining_frames_ > 0) {
+            frames_.push_back(Frame{frame_index_, frame_start_ns_, now});
+            if (--remaining_frames_ == 0) {
+                active_.store(false, std::memory_order_relaxed);
+                capture_end_ns_ = now;
+            }
+        }
+        if (armed_frames_ > 0 && remaining_frames_ == 0) {
+            for (const auto& buffer : buffers_) {
+                buffer->rewind();
+            }
+            frames_.clear();
+            capture_start_ns_ = now;
+            capture_end_ns_ = UINT64_MAX;
+            remaining_frames_ = armed_frames_;
+            armed_frames_ = 0;
+            active_.store(true, std::memory_order_relaxed);
+        }
+        frame_start_ns_ = now;
+        ++frame_index_;
+    }
+
+    /**
+     * @brief Writes the last capture to `path` in Chrome trace event format.
+     * @return False if the file could not be written.
+     */
+    bool write_chrome_trace(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Frames\"}}";
+        for (const auto& buffer : buffers_) {
+            std::string name = buffer->worker() >= 0 ? "Worker " + std::to_string(buffer->worker()) : "Thread " + std::to_string(buffer->track());
+            out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->track() << ",\"args\":{\"name\":\"" << name << "\"}}";
+            out << ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->track() << ",\"args\":{\"sort_index\":" << buffer->track() << "}}";
+        }
+
+        for (const Frame& frame : frames_) {
+            out << ",\n{\"name\":\"Frame " << frame.index << "\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":0"
+                << ",\"ts\":" << micros_(frame.start_ns - capture_start_ns_) << ",\"dur\":" << micros_(frame.end_ns - frame.start_ns) << "}";
+        }
+
+        std::vector<JobTraceEvent> events;
+        for (const auto& buffer : buffers_) {
+            events.clear();
+            buffer->snapshot(events);
+            for (const JobTraceEvent& event : events) {
+                if (event.start_ns < capture_start_ns_ || event.end_ns > capture_end_ns_) {
+                    continue;
+                }
+                out << ",\n{\"name\":\"" << to_string(event.type) << "\",\"cat\":\"job\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->track()
+                    << ",\"ts\":" << micros_(event.start_ns - capture_start_ns_) << ",\"dur\":" << micros_(event.end_ns - event.start_ns)
+                    << ",\"args\":{\"handle\":" << event.handle_id << ",\"worker\":" << event.worker
+                    << ",\"priority\":\"" << to_string(event.priority) << "\",\"stolen\":" << (event.stolen ? "true" : "false") << "}}";
+            }
+        }
+        out << "\n]}\n";
+        return static_cast<bool>(out);
+    }
+
+private:
+    struct Frame {
+        uint64_t index;
+        uint64_t start_ns;
+        uint64_t end_ns;
+    };
+
+    // Formats nanoseconds as the microseconds Chrome trace expects, keeping full precision.
+    static std::string micros_(uint64_t ns) {
+        std::string fraction = std::to_string(ns % 1000);
+        return std::to_string(ns / 1000) + "." + std::string(3 - fraction.size(), '0') + fraction;
+    }
+
+    size_t events_per_thread_;
+    std::atomic<bool> active_{false};
+
+    mutable std::mutex mutex_; // Guards everything below
+    std::vector<std::unique_ptr<JobTraceBuffer>> buffers_;
+    std::vector<Frame> frames_;
+    size_t armed_frames_ = 0;     // Frames to capture once the next frame starts
+    size_t remaining_frames_ = 0; // Frames left in the running capture
+    uint64_t frame_index_ = 0;
+    uint64_t frame_start_ns_ = 0;
+    uint64_t capture_start_ns_ = 0;
+    uint64_t capture_end_ns_ = 0;
+};
+
+}
+}
+
+#endif // JOB_TRACE_H
@@ -62,6 +62,14 @@ public:
     void update_late() {
         context_->swap();
     }
+    // Starts drawing a frame into the window: binds the default framebuffer and clears it.
+    void render() {
+        context_->set_framebuffer(0, true);
+    }
+
+    const RenderData& get_render_data() const {
+        return render_data_;
+    }
     void cleanup() {
         logger_->info("RenderManager cleanup");
         if (context_) {
@@ -104,6 +104,40 @@ public:
         return {}; 
     }
 
+    /**
+     * @brief Applies queued hierarchy edits. Module edits are held back for apply_module_edits.
+     * May run on a worker, as long as calls never overlap each other or apply_module_edits.
+     */
+    void apply_hierarchy_edits() {
+        std::vector<ObjectEdit> edits;
+        edit_queue_.pop_all(edits);
+
+        for (const auto& edit : edits) {
+            if (edit.kind == ObjectEditKind::AddModule || edit.kind == ObjectEditKind::RemoveModule) {
+                module_edits_.push_back(edit);
+            } else {
+                execute_edit_(edit);
+            }
+        }
+    }
+    // Applies the module edits apply_hierarchy_edits held back. Modules may own GPU resources,
+    // so this runs on the main thread while nothing else touches the scene.
+    void apply_module_edits() {
+        for (const auto& edit : module_edits_) {
+            execute_edit_(edit);
+        }
+        module_edits_.clear();
+    }
+
+    // Copies every object's state, parents before their children.
+    std::vector<ObjectSnapshot> snapshot() const {
+        std::vector<ObjectSnapshot> objects;
+        for (const auto& obj : context_.get_hierarchical_objects()) {
+            objects.push_back({obj->get_id(), obj->get_parent(), obj->get_level(), obj->get_modules()});
+        }
+        return objects;
+    }
+
 private:
     ngin::debug::Logger logger_;
     ngin::debug::DebugBucket debugger_;
@@ -112,6 +146,7 @@ private:
     ngin::jobs::ParallelMap<unsigned int, std::shared_ptr<Object>> object_map_;
     ngin::jobs::ParallelMap<std::string, unsigned int> name_to_id_map_;
     ngin::jobs::ParallelQueue<ObjectEdit> edit_queue_;
+    std::vector<ObjectEdit> module_edits_; // Popped by apply_hierarchy_edits, awaiting apply_module_edits
 
     ModuleManager module_mgr_;
 
@@ -22,6 +22,14 @@ struct ObjectEdit {
     ObjectEditKind kind;
 };
 
+// A copy of one object's scene state, taken for a frame so it can be read while the live object changes.
+struct ObjectSnapshot {
+    unsigned int id;
+    unsigned int parent;
+    unsigned int level;
+    std::vector<unsigned int> modules;
+};
+
 class Object {
 public:
     Object(const unsigned int id, const std::string& name) : id_(id), name_(name), parent_(0) {} // Initialize parent_ here
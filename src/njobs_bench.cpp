@@ -0,0 +1,664 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <ngin/job/algorithm.h>
+#include <ngin/job/ngin.h>
+#include <ngin/job/collections/queue.h>
+
+// std::execution::par baselines need a parallel backend (TBB for libstdc++); the build
+// defines this when it found one.
+#ifndef NJOBS_BENCH_STD_PAR
+#define NJOBS_BENCH_STD_PAR 0
+#endif
+#if NJOBS_BENCH_STD_PAR
+#include <execution>
+#endif
+
+/**
+ * @file njobs_bench.cpp
+ * @brief Headless JobNgin benchmark suite.
+ *
+ * Runs a parameter sweep over the job system without a window or GL context and writes
+ * the results as JSON, so runs can be diffed and tracked for regressions. Scenarios:
+ *
+ *  - flat:      one submit_jobs batch of `job_count` independent jobs.
+ *  - fanout:    a tree in which every job submits `fan_out` children, down to `depth` levels.
+ *  - chain:     `depth` batches of `width` jobs, each depending on the one before.
+ *  - dedicated: a mixed Physics/AI batch with `dedicated` workers reserved for Physics.
+ *  - steal:     `job_count` jobs all queued on worker 0, so every other worker lives off
+ *               stealing; run with steal batches of up to `max_steal_batch` jobs (1 = one per
+ *               steal) and reports, per job completed, steal attempts, jobs stolen and jobs
+ *               stolen again from a thief.
+ *  - reduce, scan, radix_sort, parallel_sort: the algorithms of ngin/job/algorithm.h on
+ *               `elements` random 64-bit keys, next to std_sort and, when the build has a
+ *               parallel backend, std_par_reduce, std_par_scan and std_par_sort. The std
+ *               baselines ignore the thread count. Throughput is in elements per second.
+ *  - queue_locked, queue_ring: two jobs per thread hammer one ParallelQueue, each pushing
+ *               `items` / jobs items and popping one after every push, then the caller drains
+ *               the rest with pop_all; the mutex-backed queue against the lock-free ring.
+ *               Throughput is in pushes plus pops per second.
+ *
+ * Each scenario is swept over job cost and thread count. For every configuration the report
+ * holds throughput, p50/p99 submit-to-complete latency, and scaling efficiency relative to
+ * the same configuration on one thread.
+ *
+ * Usage: njobs_bench [--quick] [--repeats N] [--threads 1,2,4] [--pin] [--out results.json]
+ */
+
+using Clock = std::chrono::steady_clock;
+using ngin::jobs::JobNgin;
+using ngin::jobs::JobNginOptions;
+
+// --- Settings and results ---
+
+struct BenchSettings {
+    bool quick = false;
+    int repeats = 3;
+    bool pin_workers = false;
+    std::vector<unsigned int> thread_counts;
+    std::string out_path; // Empty for stdout
+};
+
+// One measured configuration.
+struct BenchResult {
+    std::string scenario;
+    std::vector<std::pair<std::string, long long>> params; // Printed in order; "threads" is always present
+    size_t jobs = 0;
+    double wall_ms = 0.0;
+    double throughput = 0.0;   // Jobs per second
+    double latency_p50_us = 0.0;
+    double latency_p99_us = 0.0;
+    double scaling_efficiency = 0.0;
+    std::vector<std::pair<std::string, double>> extra; // Scenario-specific metrics
+};
+
+// Raw timings of one run, turned into a BenchResult by summarize().
+struct RunSample {
+    size_t jobs = 0;
+    double wall_ns = 0.0;
+    std::vector<uint64_t> latencies_ns;
+    std::vector<std::pair<std::string, double>> extra; // Copied to BenchResult::extra
+};
+
+static uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+}
+
+// Busy work standing in for a job's payload.
+static void spin_for_ns(uint64_t cost_ns) {
+    if (cost_ns == 0) {
+        return;
+    }
+    uint64_t until = now_ns() + cost_ns;
+    while (now_ns() < until) {
+    }
+}
+
+static double percentile(std::vector<uint64_t>& values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    size_t index = static_cast<size_t>(p * static_cast<double>(values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return static_cast<double>(values[index]);
+}
+
+static JobNginOptions make_options(const BenchSettings& settings) {
+    JobNginOptions options;
+    options.pin_workers = settings.pin_workers;
+    return options;
+}
+
+// Steal counters summed over all workers.
+struct StealCounters {
+    uint64_t attempts = 0;
+    uint64_t stolen = 0;
+    uint64_t restolen = 0;
+};
+
+static StealCounters read_steal_counters(const JobNgin& ngin) {
+    StealCounters counters;
+    for (const auto& diagnostics : ngin.get_thread_diagnostics()) {
+        counters.attempts += diagnostics.steal_attempts;
+        counters.stolen += diagnostics.jobs_stolen;
+        counters.restolen += diagnostics.jobs_restolen;
+    }
+    return counters;
+}
+
+// --- Scenarios ---
+
+static RunSample run_flat(JobNgin& ngin, size_t job_count, uint64_t cost_ns) {
+    RunSample sample;
+    sample.jobs = job_count;
+    std::vector<uint64_t> done(job_count);
+
+    std::vector<std::function<void()>> tasks;
+    tasks.reserve(job_count);
+    for (size_t i = 0; i < job_count; ++i) {
+        tasks.push_back([&done, i, cost_ns]() {
+            spin_for_ns(cost_ns);
+            done[i] = now_ns();
+        });
+    }
+
+    uint64_t start = now_ns();
+    JobHandle handle = ngin.submit_jobs(std::move(tasks), JobType::Other);
+    ngin.wait_for(handle);
+    sample.wall_ns = static_cast<double>(now_ns() - start);
+
+    sample.latencies_ns.reserve(job_count);
+    for (uint64_t end : done) {
+        sample.latencies_ns.push_back(end - start);
+    }
+    return sample;
+}
+
+struct FanoutState {
+    JobNgin* ngin;
+    uint64_t cost_ns;
+    int fan_out;
+    JobHandle handle;                   // Every job in the tree counts against it
+    std::vector<uint64_t> latencies_ns; // Indexed by job number
+    std::atomic<size_t> next_slot{0};
+};
+
+static void fanout_node(FanoutState& state, int depth, uint64_t submitted) {
+    spin_for_ns(state.cost_ns);
+    if (depth > 0) {
+        for (int child = 0; child < state.fan_out; ++child) {
+            uint64_t child_submitted = now_ns();
+            state.ngin->submit([&state, depth, child_submitted]() {
+                fanout_node(state, depth - 1, child_submitted);
+            }, JobType::Other, state.handle);
+        }
+    }
+    state.latencies_ns[state.next_slot.fetch_add(1, std::memory_order_relaxed)] = now_ns() - submitted;
+}
+
+static RunSample run_fanout(JobNgin& ngin, int fan_out, int depth, uint64_t cost_ns) {
+    size_t nodes = 0;
+    size_t level = 1;
+    for (int d = 0; d <= depth; ++d) {
+        nodes += level;
+        level *= static_cast<size_t>(fan_out);
+    }
+
+    FanoutState state;
+    state.ngin = &ngin;
+    state.cost_ns = cost_ns;
+    state.fan_out = fan_out;
+    state.latencies_ns.resize(nodes);
+
+    // Children are added to the handle while the root is still pending, so it never drains early.
+    uint64_t start = now_ns();
+    ngin.submit([&state, depth, start]() {
+        fanout_node(state, depth, start);
+    }, JobType::Other, state.handle);
+    ngin.wait_for(state.handle);
+
+    RunSample sample;
+    sample.jobs = nodes;
+    sample.wall_ns = static_cast<double>(now_ns() - start);
+    sample.latencies_ns = std::move(state.latencies_ns);
+    return sample;
+}
+
+static RunSample run_chain(JobNgin& ngin, size_t width, int depth, uint64_t cost_ns) {
+    RunSample sample;
+    sample.jobs = width * static_cast<size_t>(depth);
+    std::vector<uint64_t> done(sample.jobs);
+    std::vector<uint64_t> submitted(static_cast<size_t>(depth));
+
+    uint64_t start = now_ns();
+    JobHandle previous;
+    for (int stage = 0; stage < depth; ++stage) {
+        std::vector<std::function<void()>> tasks;
+        tasks.reserve(width);
+        for (size_t i = 0; i < width; ++i) {
+            size_t slot = static_cast<size_t>(stage) * width + i;
+            tasks.push_back([&done, slot, cost_ns]() {
+                spin_for_ns(cost_ns);
+                done[slot] = now_ns();
+            });
+        }
+        submitted[static_cast<size_t>(stage)] = now_ns();
+        std::vector<JobHandle> dependencies;
+        if (stage > 0) {
+            dependencies.push_back(previous);
+        }
+        previous = ngin.submit_jobs(std::move(tasks), JobType::Other, dependencies);
+    }
+    ngin.wait_for(previous);
+    sample.wall_ns = static_cast<double>(now_ns() - start);
+
+    sample.latencies_ns.reserve(sample.jobs);
+    for (size_t slot = 0; slot < sample.jobs; ++slot) {
+        sample.latencies_ns.push_back(done[slot] - submitted[slot / width]);
+    }
+    return sample;
+}
+
+static RunSample run_dedicated(JobNgin& ngin, size_t job_count, uint64_t cost_ns) {
+    RunSample sample;
+    sample.jobs = job_count;
+    std::vector<uint64_t> done(job_count);
+
+    std::vector<std::function<void()>> physics_tasks;
+    std::vector<std::function<void()>> ai_tasks;
+    for (size_t i = 0; i < job_count; ++i) {
+        auto task = [&done, i, cost_ns]() {
+            spin_for_ns(cost_ns);
+            done[i] = now_ns();
+        };
+        if (i % 2 == 0) {
+            physics_tasks.push_back(task);
+        } else {
+            ai_tasks.push_back(task);
+        }
+    }
+
+    uint64_t start = now_ns();
+    JobHandle physics = ngin.submit_jobs(std::move(physics_tasks), JobType::Physics);
+    JobHandle ai = ngin.submit_jobs(std::move(ai_tasks), JobType::AI);
+    ngin.wait_for(physics);
+    ngin.wait_for(ai);
+    sample.wall_ns = static_cast<double>(now_ns() - start);
+
+    sample.latencies_ns.reserve(job_count);
+    for (uint64_t end : done) {
+        sample.latencies_ns.push_back(end - start);
+    }
+    return sample;
+}
+
+// Physics is dedicated to worker 0 by the caller, so every job lands in its queue.
+static RunSample run_steal(JobNgin& ngin, size_t job_count, uint64_t cost_ns) {
+    RunSample sample;
+    sample.jobs = job_count;
+    std::vector<uint64_t> done(job_count);
+    StealCounters before = read_steal_counters(ngin);
+
+    uint64_t start = now_ns();
+    JobHandle handle;
+    for (size_t i = 0; i < job_count; ++i) {
+        ngin.submit([&done, i, cost_ns]() {
+            spin_for_ns(cost_ns);
+            done[i] = now_ns();
+        }, JobType::Physics, handle);
+    }
+    ngin.wait_for(handle);
+    sample.wall_ns = static_cast<double>(now_ns() - start);
+
+    StealCounters after = read_steal_counters(ngin);
+    // Every job has completed by now, including those the main thread ran inside wait_for.
+    double completed = static_cast<double>(std::max<size_t>(job_count, 1));
+    sample.extra.push_back({"steal_attempts_per_job", static_cast<double>(after.attempts - before.attempts) / completed});
+    sample.extra.push_back({"stolen_per_job", static_cast<double>(after.stolen - before.stolen) / completed});
+    sample.extra.push_back({"restolen_per_job", static_cast<double>(after.restolen - before.restolen) / completed});
+
+    sample.latencies_ns.reserve(job_count);
+    for (uint64_t end : done) {
+        sample.latencies_ns.push_back(end - start);
+    }
+    return sample;
+}
+
+// --- Algorithms ---
+
+static std::vector<uint64_t> random_keys(size_t count) {
+    std::mt19937_64 rng(0x5EED);
+    std::vector<uint64_t> keys(count);
+    for (uint64_t& key : keys) {
+        key = rng();
+    }
+    return keys;
+}
+
+// What an algorithm scenario leaves behind: the keys it worked on in place and, for a
+// reduction, its result.
+struct AlgorithmOutput {
+    const std::vector<uint64_t>& keys;
+    uint64_t result;
+};
+
+// One algorithm benchmark: the scenario name, its body, given the engine and the keys, and a
+// check of its output against the keys it started from.
+struct AlgorithmScenario {
+    const char* name;
+    std::function<uint64_t(JobNgin&, std::vector<uint64_t>&)> body;
+    std::function<bool(const std::vector<uint64_t>& input, const AlgorithmOutput& output)> check;
+};
+
+// Times `algorithm` over `elements` random keys, generated beforehand, then checks its output
+// outside the timed region. A wrong result fails the whole run rather than reporting a fast one.
+static RunSample run_on_keys(JobNgin& ngin, size_t elements, const AlgorithmScenario& algorithm) {
+    RunSample sample;
+    sample.jobs = elements;
+    std::vector<uint64_t> input = random_keys(elements);
+    std::vector<uint64_t> keys = input;
+    uint64_t start = now_ns();
+    uint64_t result = algorithm.body(ngin, keys);
+    sample.wall_ns = static_cast<double>(now_ns() - start);
+    if (!algorithm.check(input, AlgorithmOutput{keys, result})) {
+        std::cerr << "njobs_bench: " << algorithm.name << " produced a wrong result" << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+    return sample;
+}
+
+// Cheap stand-in for comparing against std::sort: sorted, and holding the same keys by sum and xor.
+static bool is_sorted_permutation(const std::vector<uint64_t>& input, const std::vector<uint64_t>& output) {
+    return output.size() == input.size() && std::is_sorted(output.begin(), output.end())
+        && std::accumulate(output.begin(), output.end(), uint64_t{0}) == std::accumulate(input.begin(), input.end(), uint64_t{0})
+        && std::accumulate(output.begin(), output.end(), uint64_t{0}, std::bit_xor<>()) == std::accumulate(input.begin(), input.end(), uint64_t{0}, std::bit_xor<>());
+}
+
+static bool check_sort(const std::vector<uint64_t>& input, const AlgorithmOutput& output) {
+    return is_sorted_permutation(input, output.keys);
+}
+
+static bool check_reduce(const std::vector<uint64_t>& input, const AlgorithmOutput& output) {
+    return output.result == std::accumulate(input.begin(), input.end(), uint64_t{0});
+}
+
+static bool check_scan(const std::vector<uint64_t>& input, const AlgorithmOutput& output) {
+    std::vector<uint64_t> expected(input.size());
+    std::inclusive_scan(input.begin(), input.end(), expected.begin());
+    return output.keys == expected;
+}
+
+static std::vector<AlgorithmScenario> algorithm_scenarios() {
+    std::vector<AlgorithmScenario> scenarios = {
+        {"reduce", [](JobNgin& ngin, std::vector<uint64_t>& keys) {
+            return ngin::jobs::parallel_reduce(ngin, 0, keys.size(), uint64_t{0}, [&keys](size_t i) {
+                return keys[i];
+            }, std::plus<>());
+        }, check_reduce},
+        {"scan", [](JobNgin& ngin, std::vector<uint64_t>& keys) {
+            ngin::jobs::parallel_inclusive_scan(ngin, keys.begin(), keys.end(), keys.begin(), std::plus<>());
+            return uint64_t{0};
+        }, check_scan},
+        {"radix_sort", [](JobNgin& ngin, std::vector<uint64_t>& keys) {
+            ngin::jobs::parallel_radix_sort(ngin, keys.data(), keys.size());
+            return uint64_t{0};
+        }, check_sort},
+        {"parallel_sort", [](JobNgin& ngin, std::vector<uint64_t>& keys) {
+            ngin::jobs::parallel_sort(ngin, keys.begin(), keys.end());
+            return uint64_t{0};
+        }, check_sort},
+        {"std_sort", [](JobNgin&, std::vector<uint64_t>& keys) {
+            std::sort(keys.begin(), keys.end());
+            return uint64_t{0};
+        }, check_sort},
+    };
+#if NJOBS_BENCH_STD_PAR
+    scenarios.push_back({"std_par_reduce", [](JobNgin&, std::vector<uint64_t>& keys) {
+        return std::reduce(std::execution::par, keys.begin(), keys.end(), uint64_t{0});
+    }, check_reduce});
+    scenarios.push_back({"std_par_scan", [](JobNgin&, std::vector<uint64_t>& keys) {
+        std::inclusive_scan(std::execution::par, keys.begin(), keys.end(), keys.begin());
+        return uint64_t{0};
+    }, check_scan});
+    scenarios.push_back({"std_par_sort", [](JobNgin&, std::vector<uint64_t>& keys) {
+        std::sort(std::execution::par, keys.begin(), keys.end());
+        return uint64_t{0};
+    }, check_sort});
+#endif
+    return scenarios;
+}
+
+// --- Queues ---
+
+// Two jobs per worker share `queue`, each pushing its share of `items` and trying a pop after
+// every push, so producers and consumers contend on both ends at once. A job that finds a ring
+// full pops until its push fits, so the jobs never all stall on a full ring.
+template<typename Queue>
+static RunSample run_queue(JobNgin& ngin, size_t items) {
+    Queue queue;
+    size_t jobs = static_cast<size_t>(ngin.num_threads()) * 2;
+    size_t per_job = items / jobs;
+    std::atomic<size_t> popped{0};
+
+    RunSample sample;
+    uint64_t start = now_ns();
+    JobHandle handle = ngin.parallel_for(0, jobs, 1, [&queue, &popped, per_job](size_t job) {
+        size_t local = 0;
+        uint64_t item;
+        for (size_t i = 0; i < per_job; ++i) {
+            uint64_t value = static_cast<uint64_t>(job * per_job + i);
+            while (!queue.try_push(std::move(value))) {
+                local += queue.try_pop(item) ? 1 : 0;
+            }
+            local += queue.try_pop(item) ? 1 : 0;
+        }
+        popped.fetch_add(local, std::memory_order_relaxed);
+    }, JobType::Other);
+    ngin.wait_for(handle);
+    std::vector<uint64_t> rest;
+    queue.pop_all(rest);
+    sample.wall_ns = static_cast<double>(now_ns() - start);
+    sample.jobs = per_job * jobs + popped.load(std::memory_order_relaxed) + rest.size();
+    sample.extra.push_back({"drained_by_pop_all", static_cast<double>(rest.size())});
+    return sample;
+}
+
+// --- Driver ---
+
+// Runs `run` `repeats` times on fresh engines and keeps the run with the median wall time.
+static BenchResult measure(const BenchSettings& settings, const std::string& scenario,
+                           std::vector<std::pair<std::string, long long>> params, unsigned int threads,
+                           const std::function<RunSample(JobNgin&)>& run,
+                           const std::function<void(JobNgin&)>& configure = nullptr,
+                           const JobNginOptions* options = nullptr) {
+    std::vector<RunSample> samples;
+    for (int repeat = 0; repeat < settings.repeats; ++repeat) {
+        JobNgin ngin(threads, options ? *options : make_options(settings));
+        if (configure) {
+            configure(ngin);
+        }
+        run(ngin); // Warm-up: grows pools and deques to their steady-state size
+        samples.push_back(run(ngin));
+    }
+    std::sort(samples.begin(), samples.end(), [](const RunSample& a, const RunSample& b) {
+        return a.wall_ns < b.wall_ns;
+    });
+    RunSample& median = samples[samples.size() / 2];
+
+    BenchResult result;
+    result.scenario = scenario;
+    params.insert(params.begin(), {"threads", threads});
+    result.params = std::move(params);
+    result.jobs = median.jobs;
+    result.wall_ms = median.wall_ns / 1e6;
+    result.throughput = median.wall_ns > 0.0 ? static_cast<double>(median.jobs) / (median.wall_ns / 1e9) : 0.0;
+    result.latency_p50_us = percentile(median.latencies_ns, 0.50) / 1e3;
+    result.latency_p99_us = percentile(median.latencies_ns, 0.99) / 1e3;
+    result.extra = std::move(median.extra);
+    return result;
+}
+
+// Fills in scaling efficiency: throughput / (threads * throughput of the same configuration on 1 thread).
+static void compute_scaling(std::vector<BenchResult>& results) {
+    std::map<std::string, double> single_thread;
+    auto key_of = [](const BenchResult& result) {
+        std::stringstream key;
+        key << result.scenario;
+        for (const auto& param : result.params) {
+            if (param.first != "threads") {
+                key << ';' << param.first << '=' << param.second;
+            }
+        }
+        return key.str();
+    };
+    for (const BenchResult& result : results) {
+        if (result.params.front().second == 1) {
+            single_thread[key_of(result)] = result.throughput;
+        }
+    }
+    for (BenchResult& result : results) {
+        auto it = single_thread.find(key_of(result));
+        if (it != single_thread.end() && it->second > 0.0) {
+            result.scaling_efficiency = result.throughput / (it->second * static_cast<double>(result.params.front().second));
+        }
+    }
+}
+
+static void write_json(std::ostream& out, const BenchSettings& settings, const std::vector<BenchResult>& results) {
+    out << "{\n";
+    out << "  \"benchmark\": \"njobs_bench\",\n";
+    out << "  \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "  \"repeats\": " << settings.repeats << ",\n";
+    out << "  \"pin_workers\": " << (settings.pin_workers ? "true" : "false") << ",\n";
+    out << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& result = results[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"scenario\": \"" << result.scenario << "\"";
+        for (const auto& param : result.params) {
+            out << ", \"" << param.first << "\": " << param.second;
+        }
+        out << ", \"jobs\": " << result.jobs
+            << ", \"wall_ms\": " << result.wall_ms
+            << ", \"throughput_jobs_per_s\": " << result.throughput
+            << ", \"latency_p50_us\": " << result.latency_p50_us
+            << ", \"latency_p99_us\": " << result.latency_p99_us
+            << ", \"scaling_efficiency\": " << result.scaling_efficiency;
+        for (const auto& metric : result.extra) {
+            out << ", \"" << metric.first << "\": " << metric.second;
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+static std::vector<unsigned int> default_thread_counts() {
+    unsigned int hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned int> counts;
+    for (unsigned int t = 1; t < hardware; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(hardware);
+    return counts;
+}
+
+static bool parse_args(int argc, char** argv, BenchSettings& settings) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--quick") {
+            settings.quick = true;
+        } else if (arg == "--pin") {
+            settings.pin_workers = true;
+        } else if (arg == "--repeats" && i + 1 < argc) {
+            settings.repeats = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--out" && i + 1 < argc) {
+            settings.out_path = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            std::stringstream list(argv[++i]);
+            std::string count;
+            while (std::getline(list, count, ',')) {
+                settings.thread_counts.push_back(static_cast<unsigned int>(std::max(1, std::atoi(count.c_str()))));
+            }
+        } else {
+            std::cerr << "Usage: njobs_bench [--quick] [--repeats N] [--threads 1,2,4] [--pin] [--out results.json]" << std::endl;
+            return false;
+        }
+    }
+    if (settings.thread_counts.empty()) {
+        settings.thread_counts = default_thread_counts();
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    BenchSettings settings;
+    if (!parse_args(argc, argv, settings)) {
+        return EXIT_FAILURE;
+    }
+    if (settings.quick) {
+        settings.repeats = 1;
+    }
+
+    const std::vector<size_t> job_counts = settings.quick ? std::vector<size_t>{1000, 10000} : std::vector<size_t>{1000, 10000, 100000};
+    const std::vector<uint64_t> job_costs_ns = settings.quick ? std::vector<uint64_t>{0, 2000} : std::vector<uint64_t>{0, 1000, 10000};
+    const std::vector<std::pair<int, int>> fanouts = {{2, 10}, {8, 4}, {32, 2}}; // (fan_out, depth)
+    const std::vector<int> chain_depths = settings.quick ? std::vector<int>{1, 16} : std::vector<int>{1, 16, 128};
+    const size_t chain_width = 64;
+    const size_t algorithm_elements = 1000000;
+    const size_t queue_items = settings.quick ? 200000 : 1000000;
+
+    std::vector<BenchResult> results;
+    for (unsigned int threads : settings.thread_counts) {
+        std::cerr << "njobs_bench: " << threads << " thread(s)" << std::endl;
+        for (uint64_t cost : job_costs_ns) {
+            long long cost_param = static_cast<long long>(cost);
+            for (size_t count : job_counts) {
+                results.push_back(measure(settings, "flat", {{"job_count", static_cast<long long>(count)}, {"job_cost_ns", cost_param}}, threads,
+                    [count, cost](JobNgin& ngin) { return run_flat(ngin, count, cost); }));
+            }
+            for (const auto& fanout : fanouts) {
+                int fan_out = fanout.first;
+                int depth = fanout.second;
+                results.push_back(measure(settings, "fanout", {{"fan_out", fan_out}, {"depth", depth}, {"job_cost_ns", cost_param}}, threads,
+                    [fan_out, depth, cost](JobNgin& ngin) { return run_fanout(ngin, fan_out, depth, cost); }));
+            }
+            for (int depth : chain_depths) {
+                results.push_back(measure(settings, "chain", {{"width", static_cast<long long>(chain_width)}, {"depth", depth}, {"job_cost_ns", cost_param}}, threads,
+                    [depth, cost, chain_width](JobNgin& ngin) { return run_chain(ngin, chain_width, depth, cost); }));
+            }
+            size_t dedicated_jobs = job_counts.back();
+            for (unsigned int dedicated = 0; dedicated <= std::min(threads - 1, 1u); ++dedicated) {
+                results.push_back(measure(settings, "dedicated", {{"job_count", static_cast<long long>(dedicated_jobs)}, {"dedicated", dedicated}, {"job_cost_ns", cost_param}}, threads,
+                    [dedicated_jobs, cost](JobNgin& ngin) { return run_dedicated(ngin, dedicated_jobs, cost); },
+                    [dedicated](JobNgin& ngin) {
+                        if (dedicated > 0) {
+                            ngin.dedicate_thread_to_job_type(JobType::Physics, 0);
+                        }
+                    }));
+            }
+            for (size_t batch : {size_t{1}, JobNginOptions{}.max_steal_batch}) {
+                JobNginOptions options = make_options(settings);
+                options.max_steal_batch = batch;
+                results.push_back(measure(settings, "steal", {{"job_count", static_cast<long long>(dedicated_jobs)}, {"max_steal_batch", static_cast<long long>(batch)}, {"job_cost_ns", cost_param}}, threads,
+                    [dedicated_jobs, cost](JobNgin& ngin) { return run_steal(ngin, dedicated_jobs, cost); },
+                    [](JobNgin& ngin) { ngin.dedicate_thread_to_job_type(JobType::Physics, 0); },
+                    &options));
+            }
+        }
+        for (const AlgorithmScenario& algorithm : algorithm_scenarios()) {
+            results.push_back(measure(settings, algorithm.name, {{"elements", static_cast<long long>(algorithm_elements)}}, threads,
+                [&algorithm, algorithm_elements](JobNgin& ngin) { return run_on_keys(ngin, algorithm_elements, algorithm); }));
+        }
+        results.push_back(measure(settings, "queue_locked", {{"items", static_cast<long long>(queue_items)}}, threads,
+            [queue_items](JobNgin& ngin) { return run_queue<ngin::jobs::ParallelQueue<uint64_t>>(ngin, queue_items); }));
+        results.push_back(measure(settings, "queue_ring", {{"items", static_cast<long long>(queue_items)}, {"capacity", 1024}}, threads,
+            [queue_items](JobNgin& ngin) { return run_queue<ngin::jobs::ParallelQueue<uint64_t, 1024>>(ngin, queue_items); }));
+    }
+    compute_scaling(results);
+
+    if (settings.out_path.empty()) {
+        write_json(std::cout, settings, results);
+    } else {
+        std::ofstream out(settings.out_path);
+        if (!out) {
+            std::cerr << "njobs_bench: cannot write " << settings.out_path << std::endl;
+            return EXIT_FAILURE;
+        }
+        write_json(out, settings, results);
+        std::cerr << "njobs_bench: results written to " << settings.out_path << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
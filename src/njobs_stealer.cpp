@@ -11,6 +11,7 @@
 #include <GLFW/glfw3.h>
 #include <ngin/job/ngin.h>
 #include <ngin/job/handle.h>
+#include <ngin/job/graph.h>
 
 // Include the thread-safe queue from your original files.
 #include <ngin/job/collections/queue.h>
@@ -43,15 +44,26 @@ struct RenderCommand {
     Mat4 model_matrix; // Each command stores the pre-calculated model matrix for an object.
 };
 
+/**
+ * @struct RenderCommandBatch
+ * @brief The commands generated by one job, in that worker's frame arena.
+ * Only valid until the next mark_frame(), by which time the main thread has drawn them.
+ */
+struct RenderCommandBatch {
+    const RenderCommand* commands;
+    size_t count;
+};
+
 /**
  * @typedef RenderCommandQueue
  * @brief A type alias for a thread-safe queue that will hold the generated RenderCommands.
  */
-using RenderCommandQueue = ParallelQueue<RenderCommand>;
+using RenderCommandQueue = ParallelQueue<RenderCommandBatch>;
 
 
 // Forward declarations...
 GLFWwindow* g_window = nullptr;
+bool g_trace_requested = false; // Set by the T key: capture a job trace of the next frames
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
 bool init_window();
@@ -82,6 +94,7 @@ void print_job_system_diagnostics(const ngin::jobs::JobNgin& job_system, int fps
     ss << "\x1b[2K\r";
 
     ss << "FPS - " << std::left << std::setw(4) << fps << " | ";
+    ss << "Workers - " << job_system.active_workers() << "/" << job_system.num_threads() << " | ";
     ss << "Job Total - " << std::left << std::setw(5) << total_jobs << " | Job Breakdown - ";
     
     // Iterate over the predefined list of all job types for a stable layout.
@@ -131,7 +144,10 @@ int main() {
     if (!init_window()) return -1;
     
     glfwSetKeyCallback(g_window, key_callback);
-    ngin::jobs::JobNgin job_system;
+    // Elastic: the light per-frame load here rarely needs every core, so idle workers retire.
+    ngin::jobs::JobNginOptions job_options;
+    job_options.elastic = true;
+    ngin::jobs::JobNgin job_system(std::thread::hardware_concurrency(), job_options);
 
     unsigned int shader_program = create_shader_program();
     unsigned int triangle_vao = create_triangle_vao();
@@ -159,57 +175,74 @@ int main() {
     auto last_frame_time = std::chrono::steady_clock::now();
 
 
-    std::cout << "Starting main loop with " << NUM_OBJECTS << " objects. Press ESC to exit." << std::endl;
+    // The frame's work is the same every frame, so it is declared once as a task graph and
+    // replayed. The nodes read delta_time, which the loop updates before each run.
+    float delta_time = 0.0f;
+    ngin::jobs::TaskGraph frame_graph;
+
+    // --- PHASE 1: AI update ---
+    // The graph cuts the range into a few chunks per worker; idle workers steal them.
+    ngin::jobs::TaskGraph::NodeId ai_node = frame_graph.add_range(NUM_OBJECTS, 0, [&object_angles, &object_speeds, &delta_time](size_t i) {
+        object_angles[i] += object_speeds[i] * delta_time;
+    }, JobType::AI);
+
+    // --- PHASE 2: Render command generation ---
+    // This range *depends* on the AI range: the worker that finishes the last AI chunk
+    // releases it, so run() returns straight away and the main thread keeps going while
+    // the chain runs.
+    // Each chunk writes its commands into the running worker's frame arena and queues them
+    // as one batch, so generating them costs no heap allocation and one queue lock per chunk.
+    ngin::jobs::TaskGraph::NodeId render_gen_node = frame_graph.add_range(NUM_OBJECTS, 0, [&job_system, shader_program, triangle_vao, &render_command_queue, &object_angles, &object_x_pos](size_t begin, size_t end) {
+        // By the time this chunk starts executing, every AI update will have completed
+        RenderCommand* commands = job_system.frame_arena().allocate_array<RenderCommand>(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            Mat4 model;
+            float angle = object_angles[i];
+            float x = object_x_pos[i];
+            float y = std::sin(angle * 5.0f + x * 2.0f) * 0.5f;
+            float scale = 0.05f;
+            float cosA = cos(angle);
+            float sinA = sin(angle);
+            model.elements[0] = cosA * scale;
+            model.elements[1] = sinA * scale;
+            model.elements[4] = -sinA * scale;
+            model.elements[5] = cosA * scale;
+            model.elements[12] = x;
+            model.elements[13] = y;
+            commands[i - begin] = { shader_program, triangle_vao, 3, model };
+        }
+        render_command_queue.push(RenderCommandBatch{commands, end - begin});
+    }, JobType::RenderCommandGeneration);
+    frame_graph.precede(ai_node, render_gen_node);
+    frame_graph.compile(job_system);
+
+    std::cout << "Starting main loop with " << NUM_OBJECTS << " objects. Press ESC to exit, T to capture a job trace." << std::endl;
     while (!glfwWindowShouldClose(g_window)) {
         // NEW: Delta time and FPS counter logic
         auto current_time = std::chrono::steady_clock::now();
-        float delta_time = std::chrono::duration<float>(current_time - last_frame_time).count();
+        delta_time = std::chrono::duration<float>(current_time - last_frame_time).count();
         last_frame_time = current_time;
         frame_counter++;
 
+        // Press T to write the job timeline of the next TRACE_FRAMES frames to njobs_trace.json.
+        const size_t TRACE_FRAMES = 120;
+        bool trace_was_running = job_system.is_tracing();
+        if (g_trace_requested && !trace_was_running) {
+            job_system.start_trace(TRACE_FRAMES);
+            std::cout << std::endl << "Capturing job trace of " << TRACE_FRAMES << " frames..." << std::endl;
+        }
+        g_trace_requested = false;
+        job_system.mark_frame();
+        if (trace_was_running && !job_system.is_tracing()) {
+            job_system.write_trace("njobs_trace.json");
+        }
+
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
-        // --- PHASE 1: AI Job Submission ---
-        std::vector<std::function<void()>> ai_tasks;
-        ai_tasks.reserve(NUM_OBJECTS);
-        for (int i = 0; i < NUM_OBJECTS; ++i) {
-            ai_tasks.push_back([i, &object_angles, &object_speeds, delta_time]() {
-                object_angles[i] += object_speeds[i] * delta_time;
-            });
-        }
-        // Submit all AI jobs. The submit_jobs function will wait for any specified dependencies.
-        // Since there are no dependencies here, it will submit immediately.
-        JobHandle ai_handle = job_system.submit_jobs(ai_tasks, JobType::AI);
-
-        // --- PHASE 2: Render Command Generation Job Submission ---
-        // These jobs *depend* on the AI jobs. The submit_jobs call will internally
-        // call wait_for(ai_handle) before pushing these render generation tasks to the queue.
-        std::vector<std::function<void()>> render_gen_tasks;
-        render_gen_tasks.reserve(NUM_OBJECTS);
-        for (int i = 0; i < NUM_OBJECTS; ++i) {
-             render_gen_tasks.push_back([i, shader_program, triangle_vao, &render_command_queue, &object_angles, &object_x_pos]() {
-                // By the time this task starts executing, the AI job for 'i' will have completed
-                Mat4 model;
-                float angle = object_angles[i];
-                float x = object_x_pos[i];
-                float y = std::sin(angle * 5.0f + x * 2.0f) * 0.5f;
-                float scale = 0.05f;
-                float cosA = cos(angle);
-                float sinA = sin(angle);
-                model.elements[0] = cosA * scale;
-                model.elements[1] = sinA * scale;
-                model.elements[4] = -sinA * scale;
-                model.elements[5] = cosA * scale;
-                model.elements[12] = x;
-                model.elements[13] = y;
-                RenderCommand cmd = { shader_program, triangle_vao, 3, model };
-                render_command_queue.push(cmd);
-            });
-        }
-        // Submit RenderCommandGeneration jobs, making them *depend* on the AI jobs.
-        // The main thread will block here until ai_handle is complete.
-        JobHandle render_gen_handle = job_system.submit_jobs(render_gen_tasks, JobType::RenderCommandGeneration, {ai_handle});
+        // --- PHASE 1 + 2: AI update, then render command generation ---
+        // Replays the graph built before the loop: only its counters are reset each frame.
+        JobHandle render_gen_handle = frame_graph.run(job_system);
 
         // Check if it's time to update and print diagnostics
         if (current_time - last_diag_print_time > diag_print_interval) {
@@ -223,13 +256,16 @@ int main() {
         // This implicitly ensures AI jobs are also done.
         job_system.wait_for(render_gen_handle);
 
-        std::vector<RenderCommand> commands_to_execute;
-        render_command_queue.pop_all(commands_to_execute);
+        std::vector<RenderCommandBatch> batches_to_execute;
+        render_command_queue.pop_all(batches_to_execute);
         glUseProgram(shader_program);
-        for (const auto& cmd : commands_to_execute) {
-            glUniformMatrix4fv(model_loc, 1, GL_FALSE, cmd.model_matrix.elements);
-            glBindVertexArray(cmd.vao_id);
-            glDrawArrays(GL_TRIANGLES, 0, cmd.vertex_count);
+        for (const auto& batch : batches_to_execute) {
+            for (size_t i = 0; i < batch.count; ++i) {
+                const RenderCommand& cmd = batch.commands[i];
+                glUniformMatrix4fv(model_loc, 1, GL_FALSE, cmd.model_matrix.elements);
+                glBindVertexArray(cmd.vao_id);
+                glDrawArrays(GL_TRIANGLES, 0, cmd.vertex_count);
+            }
         }
         glBindVertexArray(0);
         glfwSwapBuffers(g_window);
@@ -251,6 +287,9 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
     if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) {
         glfwSetWindowShouldClose(window, true);
     }
+    if (key == GLFW_KEY_T && action == GLFW_PRESS) {
+        g_trace_requested = true;
+    }
 }
 
 bool init_window() {